@@ -0,0 +1,217 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  BatchSolver.cpp
+//  SudokuAlgorithm
+//
+
+#include <algorithm>
+
+#include "BatchSolver.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Start the workers, one for each hardware thread when num_threads is 0
+    template <class Dimensions>
+    BasicBatchSolver<Dimensions>::BasicBatchSolver(Engine engine, unsigned num_threads) : next_puzzle_(0), solved_count_(0) {
+        if (num_threads == 0) {
+            num_threads = max(1u, thread::hardware_concurrency());
+        }
+
+        for (unsigned i = 0; i < num_threads; i++) {
+            solvers_.emplace_back(new PuzzleSolver(engine));
+        }
+
+        for (auto& solver : solvers_) {
+            workers_.emplace_back(&BasicBatchSolver::RunWorker, this, ref(*solver));
+        }
+    }
+
+    template <class Dimensions>
+    BasicBatchSolver<Dimensions>::~BasicBatchSolver() {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        batch_ready_.notify_all();
+
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+	// Solve the puzzles into the results at the same index, returns the number of puzzles solved
+    template <class Dimensions>
+    size_t BasicBatchSolver<Dimensions>::SolveBatch(const Puzzle* puzzles, SolveResult* results, size_t count) {
+        return RunBatch(puzzles, nullptr, results, nullptr, 0, count);
+    }
+
+	// Solve the puzzles read in place from a puzzle file
+    template <class Dimensions>
+    size_t BasicBatchSolver<Dimensions>::SolveBatch(const PuzzleView* puzzles, SolveResult* results, size_t count) {
+        return RunBatch(nullptr, puzzles, results, nullptr, 0, count);
+    }
+
+	// Count the solutions of the puzzles into the counts at the same index, returns the number of unique puzzles
+    template <class Dimensions>
+    size_t BasicBatchSolver<Dimensions>::CountBatch(const Puzzle* puzzles, unsigned long* counts, size_t count, unsigned long limit) {
+        return RunBatch(puzzles, nullptr, nullptr, counts, limit, count);
+    }
+
+	// Count the solutions of the puzzles read in place from a puzzle file
+    template <class Dimensions>
+    size_t BasicBatchSolver<Dimensions>::CountBatch(const PuzzleView* puzzles, unsigned long* counts, size_t count, unsigned long limit) {
+        return RunBatch(nullptr, puzzles, nullptr, counts, limit, count);
+    }
+
+	// Counters of the techniques of all the workers, recorded when SUDOKU_TECHNIQUE_STATS is defined
+    template <class Dimensions>
+    TechniqueStats BasicBatchSolver<Dimensions>::GetTechniqueStats() const {
+        lock_guard<mutex> batch_lock(batch_mutex_);
+
+        TechniqueStats stats;
+        for (const auto& solver : solvers_) {
+            stats += solver->GetTechniqueStats();
+        }
+
+        return stats;
+    }
+
+    template <class Dimensions>
+    void BasicBatchSolver<Dimensions>::ResetTechniqueStats() {
+        lock_guard<mutex> batch_lock(batch_mutex_);
+
+        for (auto& solver : solvers_) {
+            solver->ResetTechniqueStats();
+        }
+    }
+
+	// Share the cache among the solvers of the workers, nullptr solves without a cache
+    template <class Dimensions>
+    void BasicBatchSolver<Dimensions>::SetSolutionCache(BasicSolutionCache<Dimensions>* cache) {
+        lock_guard<mutex> batch_lock(batch_mutex_);
+
+        for (auto& solver : solvers_) {
+            solver->SetSolutionCache(cache);
+        }
+    }
+
+	// Hand the batch to the workers and wait until they have solved it, or counted its solutions
+	// when counts is given
+    template <class Dimensions>
+    size_t BasicBatchSolver<Dimensions>::RunBatch(const Puzzle* puzzles, const PuzzleView* views, SolveResult* results,
+                                                  unsigned long* counts, unsigned long limit, size_t count) {
+        if (count == 0) {
+            return 0;
+        }
+
+        lock_guard<mutex> batch_lock(batch_mutex_);
+
+        unique_lock<mutex> lock(mutex_);
+        puzzles_ = puzzles;
+        views_ = views;
+        results_ = results;
+        counts_ = counts;
+        limit_ = limit;
+        count_ = count;
+        next_puzzle_ = 0;
+        solved_count_ = 0;
+        error_ = nullptr;
+        busy_workers_ = GetThreadCount();
+        batch_id_++;
+        batch_ready_.notify_all();
+
+        batch_done_.wait(lock, [this] { return busy_workers_ == 0; });
+
+        puzzles_ = nullptr;
+        views_ = nullptr;
+        results_ = nullptr;
+        counts_ = nullptr;
+        count_ = 0;
+        if (error_) {
+            rethrow_exception(error_);
+        }
+
+        return solved_count_;
+    }
+
+	// Wait for the batches and solve their puzzles until the solver is destroyed
+    template <class Dimensions>
+    void BasicBatchSolver<Dimensions>::RunWorker(PuzzleSolver& solver) {
+        unsigned long last_batch_id = 0;
+
+        for (;;) {
+            const Puzzle* puzzles;
+            const PuzzleView* views;
+            SolveResult* results;
+            unsigned long* counts;
+            unsigned long limit;
+            size_t count;
+            {
+                unique_lock<mutex> lock(mutex_);
+                batch_ready_.wait(lock, [&] { return stopping_ || batch_id_ != last_batch_id; });
+                if (stopping_) {
+                    return;
+                }
+
+                last_batch_id = batch_id_;
+                puzzles = puzzles_;
+                views = views_;
+                results = results_;
+                counts = counts_;
+                limit = limit_;
+                count = count_;
+            }
+
+            size_t solved_count = 0;
+            try {
+                for (auto first = next_puzzle_.fetch_add(CHUNK_SIZE); first < count; first = next_puzzle_.fetch_add(CHUNK_SIZE)) {
+                    auto last = min(first + CHUNK_SIZE, count);
+                    for (auto i = first; i < last; i++) {
+                        if (counts) {
+                            counts[i] = puzzles ? solver.CountSolutions(puzzles[i], limit) : solver.CountSolutions(views[i], limit);
+                            if (counts[i] == 1) {
+                                solved_count++;
+                            }
+                        } else if (puzzles ? solver.Solve(puzzles[i], results[i]) : solver.Solve(views[i], results[i])) {
+                            solved_count++;
+                        }
+                    }
+                }
+            }
+            catch (...) {
+				// Stop the other workers taking more puzzles, and report the error to the caller
+                next_puzzle_ = count;
+                lock_guard<mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = current_exception();
+                }
+            }
+            solved_count_ += solved_count;
+
+            lock_guard<mutex> lock(mutex_);
+            if (--busy_workers_ == 0) {
+                batch_done_.notify_one();
+            }
+        }
+    }
+
+    template class BasicBatchSolver<Dimensions6>;
+    template class BasicBatchSolver<Dimensions9>;
+    template class BasicBatchSolver<Dimensions16>;
+    template class BasicBatchSolver<Dimensions25>;
+}
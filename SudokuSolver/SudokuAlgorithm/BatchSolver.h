@@ -0,0 +1,138 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  BatchSolver.h
+//  SudokuAlgorithm
+//
+
+#ifndef BatchSolver_h
+#define BatchSolver_h
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <cstddef>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "PuzzleSolver.h"
+#include "TechniqueStats.h"
+
+namespace SudokuAlgorithm {
+	// Solves batches of puzzles on a fixed pool of worker threads. Each worker has its
+	// own PuzzleSolver, and takes the next chunk of puzzles from a shared atomic index
+    template <class Dimensions>
+    class BasicBatchSolver final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+        using PuzzleView = BasicPuzzleView<Dimensions>;
+        using SolveResult = BasicSolveResult<Dimensions>;
+        using PuzzleSolver = BasicPuzzleSolver<Dimensions>;
+
+		// Start the workers, one for each hardware thread when num_threads is 0
+        explicit BasicBatchSolver(Engine engine = Engine::Search, unsigned num_threads = 0);
+        BasicBatchSolver(const BasicBatchSolver&) = delete;
+        BasicBatchSolver& operator= (const BasicBatchSolver&) = delete;
+
+        ~BasicBatchSolver();
+
+        unsigned GetThreadCount() const {
+            return static_cast<unsigned>(workers_.size());
+        }
+
+		// Solve the puzzles into the results at the same index, returns the number of puzzles solved.
+		// Blocks until the batch is solved; batches from several threads are solved one after another
+        std::size_t SolveBatch(const Puzzle* puzzles, SolveResult* results, std::size_t count);
+		// Solve the puzzles read in place from a puzzle file
+        std::size_t SolveBatch(const PuzzleView* puzzles, SolveResult* results, std::size_t count);
+
+        std::size_t SolveBatch(const std::vector<Puzzle>& puzzles, std::vector<SolveResult>& results) {
+            results.resize(puzzles.size());
+            return SolveBatch(puzzles.data(), results.data(), puzzles.size());
+        }
+
+        std::size_t SolveBatch(const std::vector<PuzzleView>& puzzles, std::vector<SolveResult>& results) {
+            results.resize(puzzles.size());
+            return SolveBatch(puzzles.data(), results.data(), puzzles.size());
+        }
+
+		// Count the solutions of the puzzles into the counts at the same index, each stopping once limit
+		// solutions are found. Returns the number of puzzles with exactly one solution
+        std::size_t CountBatch(const Puzzle* puzzles, unsigned long* counts, std::size_t count, unsigned long limit = 2);
+        std::size_t CountBatch(const PuzzleView* puzzles, unsigned long* counts, std::size_t count, unsigned long limit = 2);
+
+        std::size_t CountBatch(const std::vector<Puzzle>& puzzles, std::vector<unsigned long>& counts, unsigned long limit = 2) {
+            counts.resize(puzzles.size());
+            return CountBatch(puzzles.data(), counts.data(), puzzles.size(), limit);
+        }
+
+        std::size_t CountBatch(const std::vector<PuzzleView>& puzzles, std::vector<unsigned long>& counts, unsigned long limit = 2) {
+            counts.resize(puzzles.size());
+            return CountBatch(puzzles.data(), counts.data(), puzzles.size(), limit);
+        }
+
+		// Counters of the techniques of all the workers, recorded when SUDOKU_TECHNIQUE_STATS is defined
+        TechniqueStats GetTechniqueStats() const;
+        void ResetTechniqueStats();
+
+		// Share the cache among the solvers of the workers, nullptr solves without a cache
+        void SetSolutionCache(BasicSolutionCache<Dimensions>* cache);
+
+		// Puzzles taken by a worker at a time
+        static constexpr std::size_t CHUNK_SIZE = 16;
+
+    private:
+		// Hand the batch to the workers and wait until they have solved it, or counted its solutions
+		// when counts is given
+        std::size_t RunBatch(const Puzzle* puzzles, const PuzzleView* views, SolveResult* results,
+                             unsigned long* counts, unsigned long limit, std::size_t count);
+		// Wait for the batches and solve their puzzles until the solver is destroyed
+        void RunWorker(PuzzleSolver& solver);
+
+        std::vector<std::unique_ptr<PuzzleSolver>> solvers_;
+        std::vector<std::thread> workers_;
+
+		// Serializes the batches of concurrent callers
+        mutable std::mutex batch_mutex_;
+
+		// Current batch, guarded by mutex_ except the atomic counters
+        std::mutex mutex_;
+        std::condition_variable batch_ready_;
+        std::condition_variable batch_done_;
+        unsigned long batch_id_ = 0;
+        unsigned busy_workers_ = 0;
+        bool stopping_ = false;
+        const Puzzle* puzzles_ = nullptr;
+        const PuzzleView* views_ = nullptr;
+        SolveResult* results_ = nullptr;
+        unsigned long* counts_ = nullptr;
+        unsigned long limit_ = 0;
+        std::size_t count_ = 0;
+        std::atomic<std::size_t> next_puzzle_;
+        std::atomic<std::size_t> solved_count_;
+        std::exception_ptr error_;
+    };
+
+    template <class Dimensions> constexpr std::size_t BasicBatchSolver<Dimensions>::CHUNK_SIZE;
+
+    using BatchSolver = BasicBatchSolver<Dimensions9>;
+}
+
+#endif /* BatchSolver_h */
@@ -17,103 +17,55 @@
 //  SudokuAlgorithm
 //
 
+#include <array>
+
 #include "Block.h"
+#include "Row.h"
+#include "Column.h"
 
 using namespace std;
 
 namespace SudokuAlgorithm {
 	// Prepare the block for the solution
-	void Block::Initialize() {
+	template <class Dimensions>
+	void BasicBlock<Dimensions>::Initialize() {
 		Segment::Initialize();
 
+		const Marking& unsolved_nums = state_.GetUnsolvedNumbers(segment_);
 		// Mark the candidates based on the numbers present in the intersecting rows and columns
-		for (auto n : unsolved_nums_) {
-			for (auto i=0U; i<cells_.size(); i++) {
-				auto cell = cells_[i].lock();
-				if (cell->IsEmpty()) {
-					if (!row_refs_[i/row_refs_.size()].lock()->FindNumber(n) &&
-						!column_refs_[i%column_refs_.size()].lock()->FindNumber(n)) {
-						cell->GetMarking().Mark(n);
+		for (auto n : unsolved_nums) {
+			for (UShort i=0; i<GRID_WIDTH; i++) {
+				auto cell = cells_[i];
+				if (state_.IsEmpty(cell)) {
+					if (!Row(GetCellRow(cell), state_).FindNumber(n) &&
+						!Column(GetCellColumn(cell), state_).FindNumber(n)) {
+						state_.MarkCandidate(cell, n);
 					}
 				}
 			}
 		}
 	}
 
-	// Solve visible and hidden singles
-	bool Block::SolveSingles() {
-		auto solved = false;
-
-		for (auto i=0; i<cells_.size(); i++) {
-			auto cell = cells_[i].lock();
-			auto marking = cell->GetMarking();
-			UShort n;
-
-			// Update solved number to the cell if only one candidate is marked for the cell
-			if (cell->IsEmpty() && (n = marking.GetResolvedNumber()) != 0) {
-				*cell = n;
-
-				UpdateSolvedNumber(n);
-				row_refs_[i/row_refs_.size()].lock()->UpdateSolvedNumber(n);
-				column_refs_[i%row_refs_.size()].lock()->UpdateSolvedNumber(n);
-
-				solved = true;
-			}
-		}
-
-		vector<UShort> nums(unsolved_nums_);
-		// Solve hidden single
-		for (auto n : nums) {
-			UShort mark_index = 0;
-			UShort mark_count = 0;
-
-			// Count the candidate's occurances in the block
-			for (auto i=0; i<cells_.size(); i++) {
-				auto cell = cells_[i].lock();
-				if (cell->IsEmpty()) {
-					if (cell->GetMarking().IsMarked(n)) {
-						mark_index = i;
-						mark_count++;
-						if (mark_count > 1) {
-							break;
-						}
-					}
-				}
-			}
-
-			// Update the solution if a candidate occurs only once in a block
-			if (mark_count == 1) {
-				auto cell = cells_[mark_index].lock();
-				*cell = n;
-				UpdateSolvedNumber(n);
-				row_refs_[mark_index/row_refs_.size()].lock()->UpdateSolvedNumber(n);
-				column_refs_[mark_index%row_refs_.size()].lock()->UpdateSolvedNumber(n);
-
-				solved = true;
-			}
-		}
-
-		return solved;
-	}
-    
 	// Solve intersections or pointing pairs
-	bool Block::SolveIntersections() {
+	template <class Dimensions>
+	bool BasicBlock<Dimensions>::SolveIntersections() {
 		auto solved = false;
 
-		for (auto n : unsolved_nums_) {
-			if (GetCandidateCount(n) > 2) {
+		const Marking& unsolved_nums = state_.GetUnsolvedNumbers(segment_);
+		for (auto n : unsolved_nums) {
+			if (this->GetCandidateCount(n) > 2) {
 				UShort num_count = 0;
 				auto aligned_row = -1;
-				for (auto i=0; i<cells_.size(); i++) {
-					auto cell = cells_[i].lock();
-					if (cell->IsEmpty() && cell->GetMarking().IsMarked(n)) {
+				for (UShort i=0; i<GRID_WIDTH; i++) {
+					auto cell = cells_[i];
+					if (state_.IsEmpty(cell) && state_.GetMarking(cell).IsMarked(n)) {
 						num_count++;
 					}
 					// Find the row intersecting the block in which the candidate is aligned
 					// The row does not have any occurance of the candidate apart from those aligned to this block
-					if ((i + 1) % BLOCK_WIDTH == 0) {
-						if (num_count > 1 && num_count == row_refs_[i / BLOCK_WIDTH].lock()->GetCandidateCount(n)) {
-							aligned_row = i / BLOCK_WIDTH;
+					if ((i + 1) % BOX_COLUMNS == 0) {
+						if (num_count > 1 && num_count == Row(GetCellRow(cell), state_).GetCandidateCount(n)) {
+							aligned_row = i / BOX_COLUMNS;
 							break;
 						}
 						num_count = 0;
@@ -123,12 +75,10 @@ namespace SudokuAlgorithm {
 				if (aligned_row >= 0) {
 					// Erase the candidate occurances in the block,
 					// where the rows have the candidate occurances outside the block
-					for (auto i=0; i<cells_.size(); i++) {
-						if (i / BLOCK_WIDTH != aligned_row) {
-							auto cell = cells_[i].lock();
-							Marking& marking = cell->GetMarking();
-							if (cell->IsEmpty() && marking.IsMarked(n)) {
-								marking.Erase(n);
+					for (UShort i=0; i<GRID_WIDTH; i++) {
+						if (i / BOX_COLUMNS != aligned_row) {
+							auto cell = cells_[i];
+							if (state_.IsEmpty(cell) && state_.EraseCandidate(cell, n)) {
 								solved = true;
 							}
 						}
@@ -138,21 +88,21 @@ namespace SudokuAlgorithm {
 
 			if (!solved) {
 				// solve column intersections in the block if row intersections are not solved
-				array<UShort, BLOCK_WIDTH> num_counts = { 0 };
+				array<UShort, BOX_COLUMNS> num_counts = { 0 };
 
-				for (auto i=0; i<cells_.size(); i++) {
-					auto cell = cells_[i].lock();
-					if (cell->IsEmpty() && cell->GetMarking().IsMarked(n)) {
-						num_counts[i%BLOCK_WIDTH]++;
+				for (UShort i=0; i<GRID_WIDTH; i++) {
+					auto cell = cells_[i];
+					if (state_.IsEmpty(cell) && state_.GetMarking(cell).IsMarked(n)) {
+						num_counts[i%BOX_COLUMNS]++;
 					}
 				}
 
 				auto aligned_column = -1;
-				for (auto column=0; column<BLOCK_WIDTH; column++) {
+				for (UShort column=0; column<BOX_COLUMNS; column++) {
 					// Find the column intersecting the block in which the candidate is aligned
 					// The column does not have any occurance of the candidate apart from those aligned to this block
 					if (num_counts[column] > 1 &&
-						num_counts[column] == column_refs_[column].lock()->GetCandidateCount(n)) {
+						num_counts[column] == Column(GetCellColumn(cells_[column]), state_).GetCandidateCount(n)) {
 						aligned_column = column;
 						break;
 					}
@@ -161,12 +111,10 @@ namespace SudokuAlgorithm {
 				if (aligned_column >= 0) {
 					// Erase the candidate occurances in the block,
 					// where the columns have the candidate occurances outside the block
-					for (auto i=0; i<cells_.size(); i++) {
-						if (i % BLOCK_WIDTH != aligned_column) {
-							auto cell = cells_[i].lock();
-							Marking& marking = cell->GetMarking();
-							if (cell->IsEmpty() && marking.IsMarked(n)) {
-								marking.Erase(n);
+					for (UShort i=0; i<GRID_WIDTH; i++) {
+						if (i % BOX_COLUMNS != aligned_column) {
+							auto cell = cells_[i];
+							if (state_.IsEmpty(cell) && state_.EraseCandidate(cell, n)) {
 								solved = true;
 							}
 						}
@@ -177,4 +125,9 @@ namespace SudokuAlgorithm {
         
         return solved;
     }
+
+    template class BasicBlock<Dimensions6>;
+    template class BasicBlock<Dimensions9>;
+    template class BasicBlock<Dimensions16>;
+    template class BasicBlock<Dimensions25>;
 }
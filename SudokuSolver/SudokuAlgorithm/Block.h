@@ -20,49 +20,46 @@
 #ifndef Block_h
 #define Block_h
 
-#include <array>
-#include <memory>
-
 #include "SudokuAlgorithm.h"
 #include "Segment.h"
 
 namespace SudokuAlgorithm {
 	// Block in a Sudoku puzzle grid
-    class Block final : public Segment {
+    template <class Dimensions>
+    class BasicBlock final : public BasicSegment<Dimensions> {
     public:
-        Block(UShort index) : Segment(index) {
+        using Segment = BasicSegment<Dimensions>;
+        using GridState = BasicGridState<Dimensions>;
+        using Marking = BasicMarking<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort BOX_COLUMNS = Dimensions::BOX_COLUMNS;
+
+        BasicBlock(UShort index, GridState& state) : Segment(index, Dimensions::FIRST_BLOCK + index, state) {
         }
         
-		// Add reference to an intersecting row
-        void AddRowRef(const std::shared_ptr<Segment>& row) {
-            if (index_/row_refs_.size() != row->GetIndex()/row_refs_.size()) {
-                throw std::invalid_argument("row");
-            }
-            
-            row_refs_[row->GetIndex()%row_refs_.size()] = row;
-        }
-        
-		// Add reference to an intersecting column
-        void AddColumnRef(const std::shared_ptr<Segment>& column) {
-            if (index_%column_refs_.size() != column->GetIndex()/column_refs_.size()) {
-                throw std::invalid_argument("column");
-            }
-            
-            column_refs_[column->GetIndex()%column_refs_.size()] = column;
-        }
+        ~BasicBlock() = default;
         
 		// Prepare the block for the solution
 		virtual void Initialize() override;
-		// Solve visible and hidden singles
-		virtual bool SolveSingles() override;
 		// Solve intersections or pointing pairs
 		virtual bool SolveIntersections() override;
 
     private:
-		// References to the rows and columns that the block intersects
-        std::array<std::weak_ptr<Segment>, (GRID_WIDTH/BLOCK_WIDTH)> row_refs_;
-        std::array<std::weak_ptr<Segment>, (GRID_WIDTH/BLOCK_WIDTH)> column_refs_;
+        using Row = BasicRow<Dimensions>;
+        using Column = BasicColumn<Dimensions>;
+
+        using Segment::GetCellRow;
+        using Segment::GetCellColumn;
+        using Segment::segment_;
+        using Segment::cells_;
+        using Segment::state_;
     };
+
+    template <class Dimensions> constexpr UShort BasicBlock<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicBlock<Dimensions>::BOX_COLUMNS;
+
+    using Block = BasicBlock<Dimensions9>;
 }
 
 #endif /* Block_h */
@@ -0,0 +1,108 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  BoundedQueue.h
+//  SudokuAlgorithm
+//
+
+#ifndef BoundedQueue_h
+#define BoundedQueue_h
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace SudokuAlgorithm {
+	// Lock free queue of a fixed capacity, for any number of producer and consumer threads.
+	// Each cell has a sequence number that tells whether it is free for the push at its position,
+	// or holds the value for the pop at its position, so the producers and the consumers only
+	// contend on the head and tail counters
+    template <class T, std::size_t Capacity>
+    class BoundedQueue final {
+    public:
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "the capacity is a power of two");
+
+        BoundedQueue() : head_(0), tail_(0) {
+            for (std::size_t i = 0; i < Capacity; i++) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator= (const BoundedQueue&) = delete;
+
+		// Add the value at the tail, false if the queue is full
+        bool TryPush(const T& value) {
+            auto position = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& cell = cells_[position & (Capacity - 1)];
+                auto sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == position) {
+                    if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.value = value;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (sequence < position) {
+                    return false;
+                } else {
+                    position = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+		// Take the value at the head, false if the queue is empty
+        bool TryPop(T& value) {
+            auto position = head_.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& cell = cells_[position & (Capacity - 1)];
+                auto sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == position + 1) {
+                    if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        value = cell.value;
+                        cell.sequence.store(position + Capacity, std::memory_order_release);
+                        return true;
+                    }
+                } else if (sequence < position + 1) {
+                    return false;
+                } else {
+                    position = head_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+		// Cache line size, padded around the counters so the consumers and the producers do not share a line.
+		// Padding instead of alignas keeps the queue allocatable with new before C++17
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+        std::array<Cell, Capacity> cells_;
+        char cells_padding_[CACHE_LINE_SIZE];
+		// Positions of the next pop and push
+        std::atomic<std::size_t> head_;
+        char head_padding_[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+        std::atomic<std::size_t> tail_;
+        char tail_padding_[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+    };
+
+    template <class T, std::size_t Capacity> constexpr std::size_t BoundedQueue<T, Capacity>::CACHE_LINE_SIZE;
+}
+
+#endif /* BoundedQueue_h */
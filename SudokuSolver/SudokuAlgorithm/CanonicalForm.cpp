@@ -0,0 +1,325 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  CanonicalForm.cpp
+//  SudokuAlgorithm
+//
+
+#include <algorithm>
+
+#include "CanonicalForm.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+    namespace {
+		// Scramble the bits of the value, so the sums of the keys tell their multisets apart
+        uint64_t Mix(uint64_t value) {
+            value += 0x9e3779b97f4a7c15;
+            value = (value ^ (value >> 30))*0xbf58476d1ce4e5b9;
+            value = (value ^ (value >> 27))*0x94d049bb133111eb;
+            return value ^ (value >> 31);
+        }
+    }
+
+	// Find the canonical form of the puzzle, false if it has more than MAX_CANDIDATES transforms to try
+    template <class Dimensions>
+    bool BasicCanonicalForm<Dimensions>::Canonicalize(const Puzzle& puzzle) {
+        Orientation orientations[2];
+        int num_orientations = 1;
+        orientations[0].transposed = false;
+        OrderLines(puzzle, orientations[0]);
+
+		// Transposing swaps the bands and the stacks, so the orientation whose bands have the larger
+		// keys is taken, or both when the keys do not tell them apart
+        if (BAND_ROWS == STACK_COLUMNS) {
+            orientations[1].transposed = true;
+            OrderLines(puzzle, orientations[1]);
+
+            uint64_t signatures[2];
+            for (int i=0; i<2; i++) {
+                uint64_t band_sum = 0;
+                uint64_t stack_sum = 0;
+                for (UShort band=0; band<NUM_BANDS; band++) {
+                    band_sum += Mix(orientations[i].keys[BANDS_AT + band]);
+                }
+                for (UShort stack=0; stack<NUM_STACKS; stack++) {
+                    stack_sum += Mix(orientations[i].keys[STACKS_AT + stack]);
+                }
+                signatures[i] = Mix(band_sum) + stack_sum;
+            }
+
+            if (signatures[1] > signatures[0]) {
+                orientations[0] = orientations[1];
+            } else if (signatures[1] == signatures[0]) {
+                num_orientations = 2;
+            }
+        }
+
+        unsigned long candidates = 0;
+        for (int i=0; i<num_orientations; i++) {
+            candidates += CountCandidates(orientations[i]);
+        }
+        if (candidates > MAX_CANDIDATES) {
+            return false;
+        }
+
+        bool first = true;
+        for (int i=0; i<num_orientations; i++) {
+            do {
+                TryCandidate(puzzle, orientations[i], first);
+                first = false;
+            } while (NextCandidate(orientations[i]));
+        }
+
+		// The numbers missing from the puzzle take the labels left, in order
+        UShort next_label = 1;
+        for (UShort num=1; num<=NUM_BASE; num++) {
+            next_label = max(next_label, static_cast<UShort>(labels_[num] + 1));
+        }
+        for (UShort num=1; num<=NUM_BASE; num++) {
+            if (labels_[num] == 0) {
+                labels_[num] = next_label++;
+            }
+        }
+        for (UShort num=0; num<=NUM_BASE; num++) {
+            numbers_[labels_[num]] = num;
+        }
+
+        return true;
+    }
+
+	// Transform a grid of the puzzle, such as its solution, the way the puzzle was to its canonical form
+    template <class Dimensions>
+    void BasicCanonicalForm<Dimensions>::ToCanonical(const Puzzle& grid, Puzzle& canonical) const {
+        for (UShort row=0; row<GRID_WIDTH; row++) {
+            for (UShort column=0; column<GRID_WIDTH; column++) {
+                canonical[row*GRID_WIDTH + column] = labels_[GetNumber(grid, transposed_, row_map_[row], column_map_[column])];
+            }
+        }
+    }
+
+	// Transform a grid of the canonical form back to the puzzle
+    template <class Dimensions>
+    void BasicCanonicalForm<Dimensions>::FromCanonical(const Puzzle& canonical, Puzzle& grid) const {
+        for (UShort row=0; row<GRID_WIDTH; row++) {
+            for (UShort column=0; column<GRID_WIDTH; column++) {
+                auto cell = transposed_ ? column_map_[column]*GRID_WIDTH + row_map_[row] :
+                    row_map_[row]*GRID_WIDTH + column_map_[column];
+                grid[cell] = numbers_[canonical[row*GRID_WIDTH + column]];
+            }
+        }
+    }
+
+	// Order the rows and columns of the puzzle by their keys, read transposed or not. The key of a row
+	// comes from the clues in each stack and how often the numbers of its clues appear in the puzzle,
+	// and the key of a band from the keys of its rows, and the same for the columns and stacks
+    template <class Dimensions>
+    void BasicCanonicalForm<Dimensions>::OrderLines(const Puzzle& puzzle, Orientation& orientation) const {
+        array<UShort, NUM_BASE + 1> num_counts{};
+        for (auto num : puzzle) {
+            num_counts[num]++;
+        }
+
+        array<array<UShort, NUM_STACKS>, GRID_WIDTH> row_clues{};
+        array<array<UShort, NUM_BANDS>, GRID_WIDTH> column_clues{};
+        array<uint64_t, GRID_WIDTH> row_nums{};
+        array<uint64_t, GRID_WIDTH> column_nums{};
+        for (UShort row=0; row<GRID_WIDTH; row++) {
+            for (UShort column=0; column<GRID_WIDTH; column++) {
+                auto num = GetNumber(puzzle, orientation.transposed, row, column);
+                if (num != 0) {
+                    row_clues[row][column/STACK_COLUMNS]++;
+                    column_clues[column][row/BAND_ROWS]++;
+                    row_nums[row] += Mix(num_counts[num]);
+                    column_nums[column] += Mix(num_counts[num]);
+                }
+            }
+        }
+
+        auto& keys = orientation.keys;
+        for (UShort line=0; line<GRID_WIDTH; line++) {
+            uint64_t row_sum = 0;
+            for (auto clues : row_clues[line]) {
+                row_sum += Mix(clues);
+            }
+            uint64_t column_sum = 0;
+            for (auto clues : column_clues[line]) {
+                column_sum += Mix(clues);
+            }
+            keys[ROWS_AT + line] = Mix(row_sum) + row_nums[line];
+            keys[COLUMNS_AT + line] = Mix(column_sum) + column_nums[line];
+        }
+
+        for (UShort band=0; band<NUM_BANDS; band++) {
+            uint64_t sum = 0;
+            for (UShort row=0; row<BAND_ROWS; row++) {
+                sum += Mix(keys[ROWS_AT + band*BAND_ROWS + row]);
+            }
+            keys[BANDS_AT + band] = sum;
+        }
+        for (UShort stack=0; stack<NUM_STACKS; stack++) {
+            uint64_t sum = 0;
+            for (UShort column=0; column<STACK_COLUMNS; column++) {
+                sum += Mix(keys[COLUMNS_AT + stack*STACK_COLUMNS + column]);
+            }
+            keys[STACKS_AT + stack] = sum;
+        }
+
+		// Each group is sorted by decreasing key, and a tie by increasing index,
+		// the first arrangement of its permutations
+        auto& order = orientation.order;
+        ForEachGroup([&](UShort start, UShort length) {
+            array<UShort, GRID_WIDTH> indexes;
+            array<uint64_t, GRID_WIDTH> group_keys;
+            for (UShort i=0; i<length; i++) {
+                indexes[i] = i;
+                group_keys[i] = keys[start + i];
+            }
+            sort(indexes.begin(), indexes.begin() + length, [&](UShort a, UShort b) {
+                return group_keys[a] != group_keys[b] ? group_keys[a] > group_keys[b] : a < b;
+            });
+            for (UShort i=0; i<length; i++) {
+                order[start + i] = indexes[i];
+                keys[start + i] = group_keys[indexes[i]];
+            }
+            return false;
+        });
+    }
+
+	// Number of the transforms that keep the order of the keys, up to more than MAX_CANDIDATES
+    template <class Dimensions>
+    unsigned long BasicCanonicalForm<Dimensions>::CountCandidates(const Orientation& orientation) {
+        unsigned long count = 1;
+        ForEachGroup([&](UShort start, UShort length) {
+            for (UShort tie_start=0; tie_start<length; ) {
+                UShort tie_end = tie_start + 1;
+                while (tie_end < length && orientation.keys[start + tie_end] == orientation.keys[start + tie_start]) {
+                    tie_end++;
+                }
+
+				// A tie of n members takes n! arrangements
+                for (unsigned long members=2; members<=static_cast<unsigned long>(tie_end - tie_start); members++) {
+                    count *= members;
+                }
+                tie_start = tie_end;
+            }
+            return count > MAX_CANDIDATES;
+        });
+
+        return count;
+    }
+
+	// Step to the next transform that keeps the order of the keys, false after the last one.
+	// The ties step like the digits of a counter, each through the permutations of its members
+    template <class Dimensions>
+    bool BasicCanonicalForm<Dimensions>::NextCandidate(Orientation& orientation) {
+        bool stepped = false;
+        ForEachGroup([&](UShort start, UShort length) {
+            for (UShort tie_start=0; tie_start<length; ) {
+                UShort tie_end = tie_start + 1;
+                while (tie_end < length && orientation.keys[start + tie_end] == orientation.keys[start + tie_start]) {
+                    tie_end++;
+                }
+
+                auto first = orientation.order.begin() + start;
+                if (tie_end - tie_start > 1 && next_permutation(first + tie_start, first + tie_end)) {
+                    stepped = true;
+                    return true;
+                }
+                tie_start = tie_end;
+            }
+            return false;
+        });
+
+        return stepped;
+    }
+
+	// Call the function with the start and the length of each group of the order, until it returns true
+    template <class Dimensions>
+    template <class Function>
+    void BasicCanonicalForm<Dimensions>::ForEachGroup(Function function) {
+        if (function(BANDS_AT, NUM_BANDS)) {
+            return;
+        }
+        for (UShort band=0; band<NUM_BANDS; band++) {
+            if (function(static_cast<UShort>(ROWS_AT + band*BAND_ROWS), BAND_ROWS)) {
+                return;
+            }
+        }
+        if (function(STACKS_AT, NUM_STACKS)) {
+            return;
+        }
+        for (UShort stack=0; stack<NUM_STACKS; stack++) {
+            if (function(static_cast<UShort>(COLUMNS_AT + stack*STACK_COLUMNS), STACK_COLUMNS)) {
+                return;
+            }
+        }
+    }
+
+	// Try the transform of the orientation, and keep it if its puzzle is the smallest so far. The numbers
+	// are labelled in the order they appear, and the comparison stops at the first cell that is larger
+    template <class Dimensions>
+    void BasicCanonicalForm<Dimensions>::TryCandidate(const Puzzle& puzzle, const Orientation& orientation, bool first) {
+        const auto& order = orientation.order;
+        array<UShort, GRID_WIDTH> rows;
+        array<UShort, GRID_WIDTH> columns;
+        for (UShort line=0; line<GRID_WIDTH; line++) {
+            auto band = order[BANDS_AT + line/BAND_ROWS];
+            rows[line] = band*BAND_ROWS + order[ROWS_AT + band*BAND_ROWS + line%BAND_ROWS];
+            auto stack = order[STACKS_AT + line/STACK_COLUMNS];
+            columns[line] = stack*STACK_COLUMNS + order[COLUMNS_AT + stack*STACK_COLUMNS + line%STACK_COLUMNS];
+        }
+
+        Puzzle candidate;
+        array<UShort, NUM_BASE + 1> labels{};
+        UShort next_label = 1;
+        bool smaller = first;
+        for (UShort row=0; row<GRID_WIDTH; row++) {
+            for (UShort column=0; column<GRID_WIDTH; column++) {
+                auto num = GetNumber(puzzle, orientation.transposed, rows[row], columns[column]);
+                if (num != 0 && labels[num] == 0) {
+                    labels[num] = next_label++;
+                }
+
+                auto cell = row*GRID_WIDTH + column;
+                auto label = labels[num];
+                if (!smaller) {
+                    if (label > canonical_[cell]) {
+                        return;
+                    }
+                    smaller = label < canonical_[cell];
+                }
+                candidate[cell] = label;
+            }
+        }
+
+		// The same puzzle from another transform keeps the first one
+        if (!smaller) {
+            return;
+        }
+
+        canonical_ = candidate;
+        row_map_ = rows;
+        column_map_ = columns;
+        transposed_ = orientation.transposed;
+        labels_ = labels;
+    }
+
+    template class BasicCanonicalForm<Dimensions6>;
+    template class BasicCanonicalForm<Dimensions9>;
+    template class BasicCanonicalForm<Dimensions16>;
+    template class BasicCanonicalForm<Dimensions25>;
+}
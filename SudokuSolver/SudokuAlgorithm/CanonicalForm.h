@@ -0,0 +1,129 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  CanonicalForm.h
+//  SudokuAlgorithm
+//
+
+#ifndef CanonicalForm_h
+#define CanonicalForm_h
+
+#include <array>
+#include <cstdint>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+
+namespace SudokuAlgorithm {
+	// Canonical form of a puzzle under the transforms that keep a puzzle valid: relabelling the numbers,
+	// transposing the grid when the blocks are square, and permuting the bands, the stacks, the rows
+	// in a band and the columns in a stack. Equivalent puzzles have the same canonical form.
+	// The rows and columns are ordered by keys that none of the transforms change, and the transforms
+	// that keep them in order are tried for the smallest puzzle, with the numbers labelled in the order
+	// they appear. A puzzle with too many tied keys, such as a very symmetric one, is left without a form
+    template <class Dimensions>
+    class BasicCanonicalForm final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+		// Rows of a band and columns of a stack
+        static constexpr UShort BAND_ROWS = Dimensions::BOX_ROWS;
+        static constexpr UShort STACK_COLUMNS = Dimensions::BOX_COLUMNS;
+        static constexpr UShort NUM_BANDS = GRID_WIDTH/BAND_ROWS;
+        static constexpr UShort NUM_STACKS = GRID_WIDTH/STACK_COLUMNS;
+		// Transforms tried at most for a puzzle
+        static constexpr unsigned long MAX_CANDIDATES = 2048;
+
+        BasicCanonicalForm() : canonical_{}, row_map_{}, column_map_{}, labels_{}, numbers_{} {
+        }
+
+		// Find the canonical form of the puzzle, false if it has more than MAX_CANDIDATES transforms to try
+        bool Canonicalize(const Puzzle& puzzle);
+
+		// Canonical form found by the last Canonicalize
+        const Puzzle& GetPuzzle() const {
+            return canonical_;
+        }
+
+		// Transform a grid of the puzzle, such as its solution, the way the puzzle was to its canonical form
+        void ToCanonical(const Puzzle& grid, Puzzle& canonical) const;
+		// Transform a grid of the canonical form back to the puzzle
+        void FromCanonical(const Puzzle& canonical, Puzzle& grid) const;
+
+    private:
+		// Where the order of an orientation has the bands, the rows of each band by band,
+		// the stacks and the columns of each stack by stack
+        static constexpr UShort BANDS_AT = 0;
+        static constexpr UShort ROWS_AT = BANDS_AT + NUM_BANDS;
+        static constexpr UShort STACKS_AT = ROWS_AT + GRID_WIDTH;
+        static constexpr UShort COLUMNS_AT = STACKS_AT + NUM_STACKS;
+        static constexpr UShort ORDER_SIZE = COLUMNS_AT + GRID_WIDTH;
+
+		// Rows and columns of the puzzle read transposed or not, each group of them ordered by their keys.
+		// A run of equal keys in a group is a tie, and its members may take each other's place
+        struct Orientation {
+            bool transposed;
+            std::array<UShort, ORDER_SIZE> order;
+            std::array<std::uint64_t, ORDER_SIZE> keys;
+        };
+
+		// Number in the cell of the grid, read transposed or not
+        static UShort GetNumber(const Puzzle& grid, bool transposed, UShort row, UShort column) {
+            return transposed ? grid[column*GRID_WIDTH + row] : grid[row*GRID_WIDTH + column];
+        }
+
+		// Order the rows and columns of the puzzle by their keys, read transposed or not
+        void OrderLines(const Puzzle& puzzle, Orientation& orientation) const;
+		// Number of the transforms that keep the order of the keys, up to more than MAX_CANDIDATES
+        static unsigned long CountCandidates(const Orientation& orientation);
+		// Step to the next transform that keeps the order of the keys, false after the last one
+        static bool NextCandidate(Orientation& orientation);
+		// Call the function with the start and the length of each group of the order
+        template <class Function>
+        static void ForEachGroup(Function function);
+		// Try the transform of the orientation, and keep it if its puzzle is the smallest so far
+        void TryCandidate(const Puzzle& puzzle, const Orientation& orientation, bool first);
+
+        Puzzle canonical_;
+		// Row and column of the puzzle for each row and column of the canonical form
+        std::array<UShort, GRID_WIDTH> row_map_;
+        std::array<UShort, GRID_WIDTH> column_map_;
+        bool transposed_ = false;
+		// Label of each number of the puzzle in the canonical form, and the number of each label
+        std::array<UShort, NUM_BASE + 1> labels_;
+        std::array<UShort, NUM_BASE + 1> numbers_;
+    };
+
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::NUM_BASE;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::NUM_GRID_CELLS;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::BAND_ROWS;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::STACK_COLUMNS;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::NUM_BANDS;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::NUM_STACKS;
+    template <class Dimensions> constexpr unsigned long BasicCanonicalForm<Dimensions>::MAX_CANDIDATES;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::BANDS_AT;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::ROWS_AT;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::STACKS_AT;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::COLUMNS_AT;
+    template <class Dimensions> constexpr UShort BasicCanonicalForm<Dimensions>::ORDER_SIZE;
+
+    using CanonicalForm = BasicCanonicalForm<Dimensions9>;
+}
+
+#endif /* CanonicalForm_h */
@@ -18,103 +18,52 @@
 //
 
 #include "Column.h"
+#include "Row.h"
+#include "Block.h"
 
 using namespace std;
 
 namespace SudokuAlgorithm {
 	// Prepares the column for the solution
-	void Column::Initialize() {
+	template <class Dimensions>
+	void BasicColumn<Dimensions>::Initialize() {
 		Segment::Initialize();
 
+		const Marking& unsolved_nums = state_.GetUnsolvedNumbers(segment_);
 		// Mark the candidates based on the numbers present in the intersecting rows and blocks
-		for (auto n : unsolved_nums_) {
-			for (auto row=0; row<cells_.size(); row++) {
-				auto cell = cells_[row].lock();
-				if (cell->IsEmpty()) {
-					if (!row_refs_[row].lock()->FindNumber(n) &&
-						!block_refs_[row/block_refs_.size()].lock()->FindNumber(n)) {
-						cell->GetMarking().Mark(n);
+		for (auto n : unsolved_nums) {
+			for (UShort row=0; row<GRID_WIDTH; row++) {
+				auto cell = cells_[row];
+				if (state_.IsEmpty(cell)) {
+					if (!Row(row, state_).FindNumber(n) &&
+						!Block(GetCellBlock(cell), state_).FindNumber(n)) {
+						state_.MarkCandidate(cell, n);
 					}
 				}
 			}
 		}
 	}
 
-	// Solve visible and hidden singles
-	bool Column::SolveSingles() {
-		bool solved = false;
-
-		for (auto row=0; row<cells_.size(); row++) {
-			auto cell = cells_[row].lock();
-			Marking& marking = cell->GetMarking();
-			UShort n;
-
-			// Update solved number to the cell if only one candidate is marked for the cell
-			if (cell->IsEmpty() && (n = marking.GetResolvedNumber()) != 0) {
-				*cell = n;
-
-				// Update the solution in the column and the intersecting rows and blocks
-				UpdateSolvedNumber(n);
-				row_refs_[row].lock()->UpdateSolvedNumber(n);
-				block_refs_[row / block_refs_.size()].lock()->UpdateSolvedNumber(n);
-
-				solved = true;
-			}
-		}
-
-		vector<UShort> nums(unsolved_nums_);
-		// Solve hidden single
-		for (auto n : nums) {
-			UShort mark_row = 0;
-			UShort mark_count = 0;
-
-			// Count the candidate's occurances in the column
-			for (auto row = 0; row < cells_.size(); row++) {
-				auto cell = cells_[row].lock();
-				if (cell->IsEmpty()) {
-					if (cell->GetMarking().IsMarked(n)) {
-						mark_row = row;
-						mark_count++;
-						if (mark_count > 1) {
-							break;
-						}
-					}
-				}
-			}
-
-			// Update the solution if a candidate occurs only once in a column
-			if (mark_count == 1) {
-				auto cell = cells_[mark_row].lock();
-				*cell = n;
-				UpdateSolvedNumber(n);
-				row_refs_[mark_row].lock()->UpdateSolvedNumber(n);
-				block_refs_[mark_row / block_refs_.size()].lock()->UpdateSolvedNumber(n);
-
-				solved = true;
-			}
-		}
-
-		return solved;
-	}
-    
 	// Solve intersections or pointing pairs
-    bool Column::SolveIntersections() {
-		bool solved = false;
-
-		for (auto n : unsolved_nums_) {
-			if (GetCandidateCount(n) > 2) {
+    template <class Dimensions>
+    bool BasicColumn<Dimensions>::SolveIntersections() {
+        bool solved = false;
+        
+		const Marking& unsolved_nums = state_.GetUnsolvedNumbers(segment_);
+        for (auto n : unsolved_nums) {
+			if (this->GetCandidateCount(n) > 2) {
 				UShort num_count = 0;
 				auto aligned_block = -1;
-				for (auto row = 0; row < cells_.size(); row++) {
-					auto cell = cells_[row].lock();
-					if (cell->IsEmpty() && cell->GetMarking().IsMarked(n)) {
+				for (UShort row=0; row<GRID_WIDTH; row++) {
+					auto cell = cells_[row];
+					if (state_.IsEmpty(cell) && state_.GetMarking(cell).IsMarked(n)) {
 						num_count++;
 					}
 					// Find the block intersecting the column in which the candidate is aligned
 					// The block does not have any occurance of the candidate apart from those aligned to this column
-					if ((row + 1) % BLOCK_WIDTH == 0) {
-						if (num_count > 1 && num_count == block_refs_[row / BLOCK_WIDTH].lock()->GetCandidateCount(n)) {
-							aligned_block = row / BLOCK_WIDTH;
+					if ((row + 1) % BOX_ROWS == 0) {
+						if (num_count > 1 && num_count == Block(GetCellBlock(cell), state_).GetCandidateCount(n)) {
+							aligned_block = row / BOX_ROWS;
 							break;
 						}
 						num_count = 0;
@@ -123,20 +72,23 @@ namespace SudokuAlgorithm {
 
 				if (aligned_block >= 0) {
 					// Erase the candidate occurances in the column which are not aligned in a block
-					for (auto row = 0; row<cells_.size(); row++) {
-						if (row / BLOCK_WIDTH != aligned_block) {
-							auto cell = cells_[row].lock();
-							Marking& marking = cell->GetMarking();
-							if (cell->IsEmpty() && marking.IsMarked(n)) {
-								marking.Erase(n);
+					for (UShort row=0; row<GRID_WIDTH; row++) {
+						if (row / BOX_ROWS != aligned_block) {
+							auto cell = cells_[row];
+							if (state_.IsEmpty(cell) && state_.EraseCandidate(cell, n)) {
 								solved = true;
 							}
 						}
 					}
 				}
 			}
-		}
-
-		return solved;
+        }
+        
+        return solved;
     }
+
+    template class BasicColumn<Dimensions6>;
+    template class BasicColumn<Dimensions9>;
+    template class BasicColumn<Dimensions16>;
+    template class BasicColumn<Dimensions25>;
 }
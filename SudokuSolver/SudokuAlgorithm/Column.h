@@ -20,45 +20,45 @@
 #ifndef Column_h
 #define Column_h
 
-#include <array>
-#include <memory>
-
 #include "SudokuAlgorithm.h"
 #include "Segment.h"
 
 namespace SudokuAlgorithm {
 	// Column in a Sudoku puzzle grid
-    class Column final : public Segment {
+    template <class Dimensions>
+    class BasicColumn final : public BasicSegment<Dimensions> {
     public:
-        Column(UShort index) : Segment(index) {
+        using Segment = BasicSegment<Dimensions>;
+        using GridState = BasicGridState<Dimensions>;
+        using Marking = BasicMarking<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort BOX_ROWS = Dimensions::BOX_ROWS;
+
+        BasicColumn(UShort index, GridState& state) : Segment(index, Dimensions::FIRST_COLUMN + index, state) {
         }
         
-		// Add reference to an intersecting row
-        void AddRowRef(const std::shared_ptr<Segment>& row) {
-            row_refs_[row->GetIndex()] = row;
-        }
-       
-		// Add reference to an intersecting block
-        void AddBlockRef(const std::shared_ptr<Segment>& block) {
-            if (index_/block_refs_.size() != block->GetIndex()%block_refs_.size()) {
-                throw std::invalid_argument("block");
-            }
-            
-            block_refs_[block->GetIndex()/block_refs_.size()] = block;
-        }
+        ~BasicColumn() = default;
         
 		// Prepare the column for the solution
 		virtual void Initialize() override;
-		// Solve visible and hidden singles
-		virtual bool SolveSingles() override;
 		// Solve intersections or pointing pairs
 		virtual bool SolveIntersections() override;
 
     private:
-		// References to the rows and blocks that the column intersects
-        std::array<std::weak_ptr<Segment>, GRID_WIDTH> row_refs_;
-        std::array<std::weak_ptr<Segment>, GRID_WIDTH/BLOCK_WIDTH> block_refs_;
+        using Row = BasicRow<Dimensions>;
+        using Block = BasicBlock<Dimensions>;
+
+        using Segment::GetCellBlock;
+        using Segment::segment_;
+        using Segment::cells_;
+        using Segment::state_;
     };
+
+    template <class Dimensions> constexpr UShort BasicColumn<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicColumn<Dimensions>::BOX_ROWS;
+
+    using Column = BasicColumn<Dimensions9>;
 }
 
 #endif /* Column_h */
@@ -0,0 +1,231 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  DancingLinks.cpp
+//  SudokuAlgorithm
+//
+
+#include "DancingLinks.h"
+#include "GridLayout.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Build the exact cover matrix, the same for every puzzle
+    template <class Dimensions>
+    BasicDancingLinks<Dimensions>::BasicDancingLinks() : numbers_{}, solution_{} {
+		// Link the root and the column headers in a circular list
+        for (UShort header=0; header<=NUM_COLUMNS; header++) {
+            left_[header] = header == 0 ? NUM_COLUMNS : header - 1;
+            right_[header] = header == NUM_COLUMNS ? 0 : header + 1;
+            up_[header] = header;
+            down_[header] = header;
+            column_[header] = header;
+            matrix_row_[header] = 0;
+            column_size_[header] = 0;
+        }
+
+        UShort node = NUM_COLUMNS + 1;
+        for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+            auto row = GetCellRow<Dimensions>(cell);
+            auto column = GetCellColumn<Dimensions>(cell);
+            auto block = GetCellBlock<Dimensions>(cell);
+
+            for (UShort n=0; n<NUM_BASE; n++) {
+                UShort matrix_row = cell*NUM_BASE + n;
+				// Constraint columns - cell filled, number in row, number in column, number in block
+                UShort columns[] = {
+                    cell,
+                    static_cast<UShort>(NUM_GRID_CELLS + row*NUM_BASE + n),
+                    static_cast<UShort>(2*NUM_GRID_CELLS + column*NUM_BASE + n),
+                    static_cast<UShort>(3*NUM_GRID_CELLS + block*NUM_BASE + n)
+                };
+
+                UShort first = node;
+                row_nodes_[matrix_row] = first;
+                for (UShort i=0; i<4; i++, node++) {
+                    UShort header = 1 + columns[i];
+
+					// Append the node at the bottom of its column
+                    up_[node] = up_[header];
+                    down_[node] = header;
+                    down_[up_[header]] = node;
+                    up_[header] = node;
+                    column_[node] = header;
+                    column_size_[header]++;
+
+					// Link the nodes of the matrix row in a circular list
+                    left_[node] = i == 0 ? first + 3 : node - 1;
+                    right_[node] = i == 3 ? first : node + 1;
+                    matrix_row_[node] = matrix_row;
+                }
+            }
+        }
+    }
+
+	// Set the number to the cell at the given row, column
+    template <class Dimensions>
+    void BasicDancingLinks<Dimensions>::UpdateCell(UShort row, UShort column, UShort num) {
+        if (row >= GRID_WIDTH || column >= GRID_WIDTH || num > NUM_BASE) {
+            throw out_of_range("DancingLinks::UpdateCell");
+        }
+
+        numbers_[row*GRID_WIDTH + column] = num;
+    }
+
+	// Select the numbers of the puzzle and search up to limit solutions
+    template <class Dimensions>
+    unsigned long BasicDancingLinks<Dimensions>::SearchSolutions(unsigned long limit) {
+        search_nodes_ = 0;
+        solution_count_ = 0;
+        solution_limit_ = limit;
+
+		// Select the matrix rows of the numbers in the puzzle
+        array<UShort, NUM_GRID_CELLS> selected_rows;
+        UShort selected_count = 0;
+        auto consistent = true;
+        for (UShort cell=0; cell<NUM_GRID_CELLS && consistent; cell++) {
+            if (numbers_[cell] == 0) {
+                continue;
+            }
+
+            auto node = row_nodes_[cell*NUM_BASE + numbers_[cell] - 1];
+			// A column already covered means the number repeats in a row, column or block
+            auto i = node;
+            do {
+                if (right_[left_[column_[i]]] != column_[i]) {
+                    consistent = false;
+                }
+                i = right_[i];
+            } while (i != node);
+
+            if (consistent) {
+                SelectRow(node);
+                selected_rows[selected_count++] = node;
+            }
+        }
+
+        if (consistent && limit > 0) {
+            Search(0);
+        }
+
+		// Restore the matrix for the next puzzle
+        while (selected_count > 0) {
+            UnselectRow(selected_rows[--selected_count]);
+        }
+
+        return solution_count_;
+    }
+
+	// Remove the column and the rows that cover it from the matrix
+    template <class Dimensions>
+    void BasicDancingLinks<Dimensions>::Cover(UShort column) {
+        left_[right_[column]] = left_[column];
+        right_[left_[column]] = right_[column];
+
+        for (auto i = down_[column]; i != column; i = down_[i]) {
+            for (auto j = right_[i]; j != i; j = right_[j]) {
+                up_[down_[j]] = up_[j];
+                down_[up_[j]] = down_[j];
+                column_size_[column_[j]]--;
+            }
+        }
+    }
+
+	// Restore the column and its rows, in the reverse order of Cover
+    template <class Dimensions>
+    void BasicDancingLinks<Dimensions>::Uncover(UShort column) {
+        for (auto i = up_[column]; i != column; i = up_[i]) {
+            for (auto j = left_[i]; j != i; j = left_[j]) {
+                column_size_[column_[j]]++;
+                up_[down_[j]] = j;
+                down_[up_[j]] = j;
+            }
+        }
+
+        left_[right_[column]] = column;
+        right_[left_[column]] = column;
+    }
+
+	// Select the matrix row, covering all its columns
+    template <class Dimensions>
+    void BasicDancingLinks<Dimensions>::SelectRow(UShort node) {
+        Cover(column_[node]);
+        for (auto j = right_[node]; j != node; j = right_[j]) {
+            Cover(column_[j]);
+        }
+    }
+
+	// Unselect the matrix row, in the reverse order of SelectRow
+    template <class Dimensions>
+    void BasicDancingLinks<Dimensions>::UnselectRow(UShort node) {
+        for (auto j = left_[node]; j != node; j = left_[j]) {
+            Uncover(column_[j]);
+        }
+        Uncover(column_[node]);
+    }
+
+	// Search the rows that exactly cover the remaining columns, true once solution_limit_ covers are found
+    template <class Dimensions>
+    bool BasicDancingLinks<Dimensions>::Search(UShort depth) {
+        if (right_[ROOT] == ROOT) {
+			// Keep the first solution in the cells
+            if (solution_count_++ == 0) {
+                for (UShort i=0; i<depth; i++) {
+                    numbers_[solution_[i]/NUM_BASE] = solution_[i]%NUM_BASE + 1;
+                }
+            }
+            return solution_count_ >= solution_limit_;
+        }
+
+		// Branch on the column covered by the fewest rows
+        auto column = right_[ROOT];
+        for (auto header = right_[column]; header != ROOT && column_size_[column] > 1; header = right_[header]) {
+            if (column_size_[header] < column_size_[column]) {
+                column = header;
+            }
+        }
+        if (column_size_[column] == 0) {
+            return false;
+        }
+
+        Cover(column);
+
+        auto solved = false;
+        for (auto i = down_[column]; i != column && !solved; i = down_[i]) {
+            search_nodes_++;
+            solution_[depth] = matrix_row_[i];
+
+            for (auto j = right_[i]; j != i; j = right_[j]) {
+                Cover(column_[j]);
+            }
+
+            solved = Search(depth + 1);
+
+            for (auto j = left_[i]; j != i; j = left_[j]) {
+                Uncover(column_[j]);
+            }
+        }
+
+        Uncover(column);
+
+        return solved;
+    }
+
+    template class BasicDancingLinks<Dimensions6>;
+    template class BasicDancingLinks<Dimensions9>;
+    template class BasicDancingLinks<Dimensions16>;
+    template class BasicDancingLinks<Dimensions25>;
+}
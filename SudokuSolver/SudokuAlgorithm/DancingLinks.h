@@ -0,0 +1,126 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  DancingLinks.h
+//  SudokuAlgorithm
+//
+
+#ifndef DancingLinks_h
+#define DancingLinks_h
+
+#include <array>
+#include <stdexcept>
+
+#include "SudokuAlgorithm.h"
+
+namespace SudokuAlgorithm {
+	// Solves the puzzle as an exact cover problem with Knuth's Algorithm X on dancing links.
+	// Each matrix row (729 for 9x9) places a number in a cell, and covers one column
+	// for each kind of constraint (324 for 9x9) - cell filled, number in row, number in column, number in block
+    template <class Dimensions>
+    class BasicDancingLinks final {
+    public:
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+
+        BasicDancingLinks();
+        BasicDancingLinks(const BasicDancingLinks&) = delete; // links refer the nodes by index in this object
+
+        ~BasicDancingLinks() = default;
+
+		// Get the number in the given cell addressed by its row and column
+        UShort GetCellNumber(UShort row, UShort column) const {
+            if (row >= GRID_WIDTH || column >= GRID_WIDTH) {
+                throw std::out_of_range("DancingLinks::GetCellNumber");
+            }
+
+            return numbers_[row*GRID_WIDTH + column];
+        }
+
+		// Set the number to the cell at the given row, column
+        void UpdateCell(UShort row, UShort column, UShort num);
+
+		// Solve the puzzle, false if the puzzle has no solution
+        bool Solve() {
+            return SearchSolutions(1) == 1;
+        }
+
+		// Count the solutions of the puzzle, stopping once limit solutions are found.
+		// The cells hold the first solution found
+        unsigned long CountSolutions(unsigned long limit) {
+            return SearchSolutions(limit);
+        }
+
+		// Number of matrix rows tried by the search in the last solve
+        unsigned long GetSearchNodes() const {
+            return search_nodes_;
+        }
+
+        static constexpr UShort NUM_COLUMNS = 4*NUM_GRID_CELLS;
+        static constexpr UShort NUM_ROWS = NUM_GRID_CELLS*NUM_BASE;
+        static constexpr UShort NUM_NODES = 1 + NUM_COLUMNS + 4*NUM_ROWS;
+
+        static_assert(1 + NUM_COLUMNS + 4*static_cast<unsigned long>(NUM_ROWS) <= 0xFFFF, "nodes are indexed by UShort");
+
+    private:
+		// Select the numbers of the puzzle and search up to limit solutions
+        unsigned long SearchSolutions(unsigned long limit);
+		// Remove the column and the rows that cover it from the matrix
+        void Cover(UShort column);
+		// Restore the column and its rows, in the reverse order of Cover
+        void Uncover(UShort column);
+		// Select the matrix row, covering all its columns
+        void SelectRow(UShort node);
+		// Unselect the matrix row, in the reverse order of SelectRow
+        void UnselectRow(UShort node);
+		// Search the rows that exactly cover the remaining columns, true once solution_limit_ covers are found
+        bool Search(UShort depth);
+
+        static constexpr UShort ROOT = 0;
+
+		// Links of the nodes; the root is node 0, followed by the column headers and the row nodes
+        std::array<UShort, NUM_NODES> left_;
+        std::array<UShort, NUM_NODES> right_;
+        std::array<UShort, NUM_NODES> up_;
+        std::array<UShort, NUM_NODES> down_;
+        std::array<UShort, NUM_NODES> column_;
+        std::array<UShort, NUM_NODES> matrix_row_;
+        std::array<UShort, NUM_COLUMNS + 1> column_size_;
+		// First node of each matrix row
+        std::array<UShort, NUM_ROWS> row_nodes_;
+
+        std::array<UShort, NUM_GRID_CELLS> numbers_;
+		// Matrix rows selected by the search
+        std::array<UShort, NUM_GRID_CELLS> solution_;
+
+        unsigned long search_nodes_ = 0;
+		// Covers found by the search, which stops when it reaches the limit
+        unsigned long solution_count_ = 0;
+        unsigned long solution_limit_ = 1;
+    };
+
+    template <class Dimensions> constexpr UShort BasicDancingLinks<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicDancingLinks<Dimensions>::NUM_BASE;
+    template <class Dimensions> constexpr UShort BasicDancingLinks<Dimensions>::NUM_GRID_CELLS;
+    template <class Dimensions> constexpr UShort BasicDancingLinks<Dimensions>::NUM_COLUMNS;
+    template <class Dimensions> constexpr UShort BasicDancingLinks<Dimensions>::NUM_ROWS;
+    template <class Dimensions> constexpr UShort BasicDancingLinks<Dimensions>::NUM_NODES;
+    template <class Dimensions> constexpr UShort BasicDancingLinks<Dimensions>::ROOT;
+
+    using DancingLinks = BasicDancingLinks<Dimensions9>;
+}
+
+#endif /* DancingLinks_h */
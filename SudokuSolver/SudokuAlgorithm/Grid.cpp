@@ -18,100 +18,78 @@
 //
 
 #include <iostream>
+#include <utility>
 
 #include "Grid.h"
+#include "SinglesKernel.h"
 
 using namespace std;
 
 namespace SudokuAlgorithm {
-    // Allocate the arrays and initialize the cross references
-    void Grid::Initialize() {
-        for (auto i=0; i<NUM_GRID_CELLS ;i++) {
-            cells_[i] = make_shared<Cell>();
+    namespace {
+        // Construct the segments of a type, referring them to the grid state
+        template <class T, class GridState, size_t... Index>
+        array<T, sizeof...(Index)> MakeSegments(GridState& state, index_sequence<Index...>) {
+            return {{ T(Index, state)... }};
         }
-        
-        for (UShort n=0; n<GRID_WIDTH ;n++) {
-            rows_[n] = make_shared<Row>(n);
-            
-            columns_[n] = make_shared<Column>(n);
-            
-            blocks_[n] = make_shared<Block>(n);
-        }
-        
-        // Initialize each row, column and block with their respective cells
-        for (auto cell : cells_) {
-            Row& row = *rows_.at(cell->GetRow());
-            row[cell->GetColumn()] = cell;
-            
-            Column& col = *columns_.at(cell->GetColumn());
-            col[cell->GetRow()] = cell;
-            
-            Block& block = *blocks_.at(((cell->GetRow()/BLOCK_WIDTH)*BLOCK_WIDTH) + (cell->GetColumn()/BLOCK_WIDTH));
-            auto block_row = cell->GetRow() - (block.GetIndex()/BLOCK_WIDTH)*BLOCK_WIDTH;
-            auto block_column = cell->GetColumn() % BLOCK_WIDTH;
-            block[block_row*BLOCK_WIDTH+block_column] = cell;
-        }
-        
-        // Initialize the rows<->columns cross references
-        for (auto row : rows_) {
-            for (auto column : columns_) {
-                row->AddColumnRef(column);
-                column->AddRowRef(row);
-            }
-        }
-        
-        // Initialize the blocks<->rows and blocks<->columns cross references
-        for (auto block : blocks_) {
-            for (auto row : rows_) {
-                if (block->GetIndex()/BLOCK_WIDTH == row->GetIndex()/BLOCK_WIDTH) {
-                    block->AddRowRef(row);
-                    row->AddBlockRef(block);
-                }
-            }
-            for (auto column : columns_) {
-                if (block->GetIndex()%BLOCK_WIDTH == column->GetIndex()/BLOCK_WIDTH) {
-                    block->AddColumnRef(column);
-                    column->AddBlockRef(block);
-                }
-            }
+    }
+
+    // Initialize the rows, columns and blocks on the cells in the grid state
+    template <class Dimensions>
+    BasicGrid<Dimensions>::BasicGrid() :
+        rows_(MakeSegments<Row>(state_, make_index_sequence<GRID_WIDTH>())),
+        columns_(MakeSegments<Column>(state_, make_index_sequence<GRID_WIDTH>())),
+        blocks_(MakeSegments<Block>(state_, make_index_sequence<GRID_WIDTH>())) {
+        for (UShort n=0; n<GRID_WIDTH; n++) {
+            segments_[Dimensions::FIRST_ROW + n] = &rows_[n];
+            segments_[Dimensions::FIRST_COLUMN + n] = &columns_[n];
+            segments_[Dimensions::FIRST_BLOCK + n] = &blocks_[n];
         }
     }
     
     // Set the number to the cell at the given row, column
-    void Grid::UpdateCell(UShort row, UShort column, UShort num) {
-        if (row >= GRID_WIDTH || column >= GRID_WIDTH) {
+    template <class Dimensions>
+    void BasicGrid<Dimensions>::UpdateCell(UShort row, UShort column, UShort num) {
+        if (row >= GRID_WIDTH || column >= GRID_WIDTH || num > NUM_BASE) {
             throw std::out_of_range("Grid::UpdateCell");
         }
         
-        Cell& cell = *cells_[row*GRID_WIDTH+column];
-        cell = num;
+        state_.SetNumber(row*GRID_WIDTH+column, num);
     }
     
     // Display the numbers in the grid
-    void Grid::DisplayGrid() const {
-        auto row_separator = " ----- ----- ----- \n";
+    template <class Dimensions>
+    void BasicGrid<Dimensions>::DisplayGrid() const {
+        string row_separator;
+        for (UShort block=0; block<GRID_WIDTH/Dimensions::BOX_COLUMNS; block++) {
+            row_separator += " " + string(2*Dimensions::BOX_COLUMNS - 1, '-');
+        }
+        row_separator += " \n";
         
-        for (auto cell : cells_) {
-            if (cell->GetColumn() == 0 &&
-                cell->GetRow() % 3 == 0) {
+        for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+            auto row = GetCellRow<Dimensions>(cell);
+            auto column = GetCellColumn<Dimensions>(cell);
+
+            if (column == 0 &&
+                row % Dimensions::BOX_ROWS == 0) {
                     cout << row_separator;
             }
             
-            if (cell->GetColumn() % 3 == 0) {
+            if (column % Dimensions::BOX_COLUMNS == 0) {
                 cout << "|";
             } else {
                 cout << " ";
             }
             
-            if (cell->IsEmpty()) {
+            if (state_.IsEmpty(cell)) {
                 cout << "X";
             } else {
-                cout << cell->GetNumber();
+                cout << GetNumberChar(state_.GetNumber(cell));
             }
             
-            if (cell->GetColumn() == 8) {
+            if (column == GRID_WIDTH - 1) {
                 cout << "|" << endl;
-                if (cell->GetRow() == 8) {
+                if (row == GRID_WIDTH - 1) {
                     cout << row_separator;
                 }
             }
@@ -119,187 +97,479 @@ namespace SudokuAlgorithm {
     }
     
     // Solve the puzzle
-    bool Grid::Solve() {
-        vector<shared_ptr<Segment>> unfilled_segs;
-        
-        auto erase_filled_segments = [] (vector<shared_ptr<Segment>>& unfilled_segs) {
-			auto itr = unfilled_segs.begin();
-            while (itr != unfilled_segs.end()) {
-                auto seg = *itr;
-                if (seg->IsFilled()) {
-                    itr = unfilled_segs.erase(itr);
-                } else {
-                    itr++;
-                }
-            }
-        };
-        
-		// Intialize the row, column, block cross references
+    template <class Dimensions>
+    bool BasicGrid<Dimensions>::Solve(SolveMode mode) {
+        Initialize();
+        solution_limit_ = 1;
+
+        if (mode == SolveMode::Search) {
+            return state_.IsConsistent() && Search();
+        }
+
+		// A grid filled by the given numbers is solved only if no number repeats
+        return state_.IsConsistent() && SolveTechniques();
+    }
+
+    // Count the solutions of the puzzle by search, stopping once limit solutions are found.
+    // The grid is left in the state of the last branch searched, not a solution
+    template <class Dimensions>
+    unsigned long BasicGrid<Dimensions>::CountSolutions(unsigned long limit) {
+        Initialize();
+        solution_limit_ = limit;
+
+        if (limit > 0 && state_.IsConsistent()) {
+            Search();
+        }
+
+        return solution_count_;
+    }
+
+    // Prepare the candidates and the unsolved numbers of the segments for a solve
+    template <class Dimensions>
+    void BasicGrid<Dimensions>::Initialize() {
+        search_nodes_ = 0;
+        solution_count_ = 0;
+
+		// Intialize the candidates and the unsolved numbers of the rows, columns and blocks
         for (UShort n=0; n<GRID_WIDTH; n++) {
-            rows_[n]->Initialize();
+            rows_[n].Initialize();
             
-            columns_[n]->Initialize();
+            columns_[n].Initialize();
             
-            blocks_[n]->Initialize();
+            blocks_[n].Initialize();
         }
+        state_.QueueAllSegments();
+    }
+
+    // Apply the solving techniques until the puzzle is solved or no further progress is made.
+    // Only the segments whose candidates changed since they were last examined are revisited
+    template <class Dimensions>
+    bool BasicGrid<Dimensions>::SolveTechniques() {
+        for (;;) {
+			// Solve visible and hidden singles first
+            ApplyTechnique(Technique::Singles, [this] { return SolveSingles(); });
 
-		// Create the list of segments not filled
-        for (auto seg : rows_) {
-            if (!seg->IsFilled()) {
-                unfilled_segs.push_back(seg);
+            if (IsFilled()) {
+                return true;
             }
+
+			// Solve intersections, visible subsets and hidden subsets in the queued segments,
+			// and go back to the singles as soon as a candidate is erased
+            auto solved = false;
+            UShort segment;
+            while (!solved && state_.NextQueuedSegment(segment)) {
+                auto seg = segments_[segment];
+                if (!seg->IsFilled()) {
+                    solved = ApplyTechnique(Technique::Intersections, [seg] { return seg->SolveIntersections(); }) ||
+                             ApplyTechnique(Technique::VisibleSubsets, [seg] { return seg->SolveVisibleSubsets(); }) ||
+                             ApplyTechnique(Technique::HiddenSubsets, [seg] { return seg->SolveHiddenSubsets(); });
+                }
+            }
+
+			// An intersection also depends on the candidates of the crossing segments, so all the
+			// segments are checked once the queue is empty, and then the fish on the whole grid
+            if (!solved) {
+                for (auto seg : segments_) {
+                    if (!seg->IsFilled() &&
+                        ApplyTechnique(Technique::Intersections, [seg] { return seg->SolveIntersections(); })) {
+                        solved = true;
+                    }
+                }
+            }
+
+            if (!solved) {
+                solved = ApplyTechnique(Technique::Fish, [this] { return SolveFish(); });
+            }
+
+			// The wings and the coloring are tried last, as they look at the whole grid
+            if (!solved) {
+                solved = ApplyTechnique(Technique::XYWing, [this] { return SolveXYWing(); }) ||
+                         ApplyTechnique(Technique::XYZWing, [this] { return SolveXYZWing(); }) ||
+                         ApplyTechnique(Technique::SimpleColoring, [this] { return SolveSimpleColoring(); });
+            }
+
+            if (!solved) {
+                return false;
+            }
+        }
+    }
+
+    // Solve naked and hidden singles of the whole grid, until none are left
+    template <class Dimensions>
+    bool BasicGrid<Dimensions>::SolveSingles() {
+        auto solved = false;
+        SinglesMasks<Dimensions> masks;
+
+        for (;;) {
+            FindSingles(state_, masks);
+            auto progress = false;
+
+			// Naked singles, if the cell still has the single candidate after the earlier updates
+            for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+                auto single = masks.naked_[cell];
+                if (single != 0 && state_.GetMarking(cell).GetNumbers() == single) {
+                    state_.SolveCell(cell, Marking(single).GetResolvedNumber());
+                    progress = true;
+                }
+            }
+
+			// Hidden singles, the unsolved numbers seen once in a segment
+            for (UShort segment=0; segment<NUM_SEGMENTS; segment++) {
+                Marking hidden(masks.seen_once_[segment] & ~masks.seen_twice_[segment]);
+                hidden.Intersect(state_.GetUnsolvedNumbers(segment));
+                for (auto n : hidden) {
+					// The single position left, unless an earlier update erased the number
+                    auto positions = state_.GetPositions(segment, n);
+                    if (positions != 0) {
+                        auto position = Marking::Bits::GetLowestNumber(positions) - 1;
+                        state_.SolveCell(GRID_LAYOUT<Dimensions>.segment_cells_[segment][position], n);
+                        progress = true;
+                    }
+                }
+            }
+
+            if (!progress) {
+                return solved;
+            }
+            solved = true;
         }
-        for (auto seg : columns_) {
-            if (!seg->IsFilled()) {
-                unfilled_segs.push_back(seg);
+    }
+
+    // Search the solutions depth first, guessing the candidates of the cell with the fewest candidates.
+    // The techniques propagate each guess, and the grid is restored from a snapshot when the guess fails
+    // or when more solutions are wanted. The grid keeps the solution that reaches the limit
+    template <class Dimensions>
+    bool BasicGrid<Dimensions>::Search() {
+        if (SolveTechniques()) {
+            if (!state_.IsConsistent()) {
+                return false;
             }
+            solution_count_++;
+            return solution_count_ >= solution_limit_;
+        }
+        if (!state_.IsConsistent()) {
+            return false;
         }
-        for (auto seg : blocks_) {
-            if (!seg->IsFilled()) {
-                unfilled_segs.push_back(seg);
+
+        UShort guess_cell = NUM_GRID_CELLS;
+        UShort least_count = NUM_BASE + 1;
+        for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+            if (state_.IsEmpty(cell)) {
+                auto count = state_.GetMarking(cell).GetCount();
+                if (count < least_count) {
+                    least_count = count;
+                    guess_cell = cell;
+                    if (count == 2) {
+                        break;
+                    }
+                }
             }
         }
-        
-		while (unfilled_segs.size() > 0) {
-			sort(begin(unfilled_segs), end(unfilled_segs),
-				[](shared_ptr<Segment> sega, shared_ptr<Segment> segb)
-			{
-				return sega->GetEmptyCellCount() < segb->GetEmptyCellCount();
-			});
-
-			auto solved = false;
-			// Solve visible and hidden singles first
-			for (auto seg : unfilled_segs) {
-				if (seg->SolveSingles()) {
-					solved = true;
+
+        GridSnapshot snapshot;
+        SaveSnapshot(snapshot);
+
+        const Marking candidates = state_.GetMarking(guess_cell);
+        for (auto n : candidates) {
+            search_nodes_++;
+            state_.SolveCell(guess_cell, n);
+            if (Search()) {
+                return true;
+            }
+            RestoreSnapshot(snapshot);
+        }
+
+        return false;
+    }
+
+	// Solve the candidates by finding fish patterns - X Wing, Swordfish and Jellyfish -
+	// with the rows or the columns as the base lines, the smaller fish first
+	template <class Dimensions>
+	bool BasicGrid<Dimensions>::SolveFish() {
+		for (UShort size=2; size<=MAX_FISH_SIZE; size++) {
+			for (UShort n=1; n<=NUM_BASE; n++) {
+				if (SolveFish(n, size, Dimensions::FIRST_ROW, Dimensions::FIRST_COLUMN) ||
+					SolveFish(n, size, Dimensions::FIRST_COLUMN, Dimensions::FIRST_ROW)) {
+					return true;
 				}
 			}
+		}
+
+		return false;
+	}
 
-			if (solved) {
-				erase_filled_segments(unfilled_segs);
+	// Find a fish of the size for the number, and erase the number from the cover lines outside the base lines.
+	// The positions of the number in a base line are the cover lines it meets, so a fish is a set of
+	// base lines whose positions together cover as many lines as there are base lines
+	template <class Dimensions>
+	bool BasicGrid<Dimensions>::SolveFish(UShort num, UShort size, UShort first_base, UShort first_cover) {
+		using Mask = typename Dimensions::Mask;
+
+		// Base lines where the number has 2 to size positions
+		array<UShort, GRID_WIDTH> lines;
+		array<Mask, GRID_WIDTH> line_positions;
+		UShort num_lines = 0;
+		for (UShort line=0; line<GRID_WIDTH; line++) {
+			auto positions = state_.GetPositions(first_base + line, num);
+			auto count = Marking::Bits::GetCount(positions);
+			if (count >= 2 && count <= size) {
+				lines[num_lines] = line;
+				line_positions[num_lines] = positions;
+				num_lines++;
 			}
+		}
 
-			// Solve intersections, visible subsets and hidden subsets
-			for (auto seg : unfilled_segs) {
-				if (seg->SolveIntersections()) {
-					solved = true;
+		// Enumerate the combinations of size base lines in order, dropping a partial combination
+		// as soon as it covers more than size lines
+		array<UShort, MAX_FISH_SIZE> chosen;
+		array<Mask, MAX_FISH_SIZE + 1> covers;
+		covers[0] = 0;
+		chosen[0] = 0;
+		UShort depth = 0;
+		for (;;) {
+			if (chosen[depth] + size - depth > num_lines) {
+				if (depth == 0) {
+					return false;
 				}
+				depth--;
+				chosen[depth]++;
+				continue;
 			}
 
-			for (auto seg : unfilled_segs) {
-				if (seg->SolveVisibleSubsets()) {
-					solved = true;
-				}
+			auto cover = static_cast<Mask>(covers[depth] | line_positions[chosen[depth]]);
+			auto cover_count = Marking::Bits::GetCount(cover);
+			if (depth + 1 < size && cover_count <= size) {
+				covers[depth + 1] = cover;
+				chosen[depth + 1] = chosen[depth] + 1;
+				depth++;
+				continue;
 			}
-		
-			for (auto seg : unfilled_segs) {
-				if (seg->SolveHiddenSubsets()) {
-					solved = true;
+
+			if (depth + 1 == size && cover_count == size) {
+				Mask base = 0;
+				for (UShort i=0; i<size; i++) {
+					base |= static_cast<Mask>(1u << lines[chosen[i]]);
 				}
-			}
 
-			// If simple methods does not find any solution, solve X Wing
-			if (!solved) {
-				solved = SolveXWing();
+				// Positions in a cover line are indexed by the base lines
+				auto solved = false;
+				for (auto lines_left = cover; lines_left != 0; lines_left &= lines_left - 1) {
+					UShort cover_line = first_cover + Marking::Bits::GetLowestNumber(lines_left) - 1;
+					for (Mask outside = state_.GetPositions(cover_line, num) & ~base; outside != 0; outside &= outside - 1) {
+						auto position = Marking::Bits::GetLowestNumber(outside) - 1;
+						if (state_.EraseCandidate(GRID_LAYOUT<Dimensions>.segment_cells_[cover_line][position], num)) {
+							solved = true;
+						}
+					}
+				}
+
+				if (solved) {
+					return true;
+				}
 			}
 
-			if (solved) {
+			chosen[depth]++;
+		}
+	}
+
+	// Solve the candidates by finding XY-Wings. The pivot has the candidates xy, and sees a pincer with xz
+	// and another with yz, so one of the pincers is z and z is erased from the cells that see both pincers
+	template <class Dimensions>
+	bool BasicGrid<Dimensions>::SolveXYWing() {
+		using Mask = typename Dimensions::Mask;
+		const auto& layout = GRID_LAYOUT<Dimensions>;
+
+		for (UShort pivot=0; pivot<NUM_GRID_CELLS; pivot++) {
+			auto pivot_nums = state_.GetMarking(pivot).GetNumbers();
+			if (Marking::Bits::GetCount(pivot_nums) != 2) {
 				continue;
-			} else {
-				break;
 			}
-        }
-        
-        return unfilled_segs.size() == 0;
-    }
 
-	// Solve the candidates by identifying X Wing pattern in the grid
-	bool Grid::SolveXWing() {
-		auto solved = false;
+			// Peers with two candidates, one of them shared with the pivot
+			array<UShort, GridLayout<Dimensions>::NUM_PEERS> pincers;
+			UShort num_pincers = 0;
+			for (auto peer : layout.cell_peers_[pivot]) {
+				auto nums = state_.GetMarking(peer).GetNumbers();
+				if (Marking::Bits::GetCount(nums) == 2 && Marking::Bits::GetCount(nums & pivot_nums) == 1) {
+					pincers[num_pincers++] = peer;
+				}
+			}
 
-		for (UShort n=1; n<=NUM_BASE; n++) {
-			int x1, x2, y1, y2;
-
-			// Find if the candidate is present in a X Wing pattern,
-			// and the rows forming the pattern does not have the candidate
-			// apart from the cells forming the pattern
-			x1 = x2 = y1 = y2 = -1;
-			for (UShort row = 0; row<GRID_WIDTH; row++) {
-				if (!rows_[row]->IsFilled() && rows_[row]->GetCandidateCount(n) == 2) {
-					y1 = row;
-					break;
+			for (UShort i=0; i<num_pincers; i++) {
+				auto first_nums = state_.GetMarking(pincers[i]).GetNumbers();
+				for (UShort j=i+1; j<num_pincers; j++) {
+					auto second_nums = state_.GetMarking(pincers[j]).GetNumbers();
+					auto common = static_cast<Mask>(first_nums & second_nums & ~pivot_nums);
+					if (first_nums == second_nums || common == 0) {
+						continue;
+					}
+
+					auto num = Marking::Bits::GetLowestNumber(common);
+					auto solved = false;
+					for (auto peer : layout.cell_peers_[pincers[i]]) {
+						if (IsPeer<Dimensions>(peer, pincers[j]) && state_.EraseCandidate(peer, num)) {
+							solved = true;
+						}
+					}
+
+					if (solved) {
+						return true;
+					}
 				}
 			}
-			if (y1 < 0) {
+		}
+
+		return false;
+	}
+
+	// Solve the candidates by finding XYZ-Wings. The pivot has the candidates xyz, and sees a pincer with xz
+	// and another with yz, so one of the three is z and z is erased from the cells that see all of them
+	template <class Dimensions>
+	bool BasicGrid<Dimensions>::SolveXYZWing() {
+		const auto& layout = GRID_LAYOUT<Dimensions>;
+
+		for (UShort pivot=0; pivot<NUM_GRID_CELLS; pivot++) {
+			auto pivot_nums = state_.GetMarking(pivot).GetNumbers();
+			if (Marking::Bits::GetCount(pivot_nums) != 3) {
 				continue;
 			}
 
-			for (UShort column=0; column<GRID_WIDTH; column++) {
-				auto cell = (*rows_[y1])[column].lock();
-				if (cell->IsEmpty() && cell->GetMarking().IsMarked(n)) {
-					if (x1 < 0) {
-						x1 = column;
-					} else {
-						x2 = column;
-						break;
-					}	
+			// Peers with two of the candidates of the pivot
+			array<UShort, GridLayout<Dimensions>::NUM_PEERS> pincers;
+			UShort num_pincers = 0;
+			for (auto peer : layout.cell_peers_[pivot]) {
+				auto nums = state_.GetMarking(peer).GetNumbers();
+				if (Marking::Bits::GetCount(nums) == 2 && (nums & ~pivot_nums) == 0) {
+					pincers[num_pincers++] = peer;
 				}
 			}
 
-			if (x1 >= 0 && x2 >= 0) {
-				for (UShort row=0; row<GRID_WIDTH; row++) {
-					if (row == y1) {
+			for (UShort i=0; i<num_pincers; i++) {
+				auto first_nums = state_.GetMarking(pincers[i]).GetNumbers();
+				for (UShort j=i+1; j<num_pincers; j++) {
+					auto second_nums = state_.GetMarking(pincers[j]).GetNumbers();
+					if (first_nums == second_nums) {
 						continue;
 					}
 
-					if (!rows_[row]->IsFilled() && rows_[row]->GetCandidateCount(n) == 2) {
-						auto cell_y2x1 = (*rows_[row])[x1].lock();
-						auto cell_y2x2 = (*rows_[row])[x2].lock();
-
-						if ((cell_y2x1->IsEmpty() && cell_y2x2->IsEmpty()) &&
-							(cell_y2x1->GetMarking().IsMarked(n) && cell_y2x2->GetMarking().IsMarked(n))) {
-							y2 = row;
-							break;
+					// The cells that see the pivot and both the pincers share the block or the line of the pivot
+					auto num = Marking::Bits::GetLowestNumber(first_nums & second_nums);
+					auto solved = false;
+					for (auto peer : layout.cell_peers_[pivot]) {
+						if (IsPeer<Dimensions>(peer, pincers[i]) && IsPeer<Dimensions>(peer, pincers[j]) &&
+							state_.EraseCandidate(peer, num)) {
+							solved = true;
 						}
 					}
+
+					if (solved) {
+						return true;
+					}
 				}
 			}
+		}
 
-			if (y2 > 0) {
-				// Erase the outlying candidates in the rows which intersect the X Wing
-				for (UShort row=0; row<GRID_WIDTH; row++) {
-					if (row == y1 || row == y2) {
-						continue;
-					}
-					auto cell_x1 = (*rows_[row])[x1].lock();
-					auto cell_x2 = (*rows_[row])[x2].lock();
-					if ((cell_x1->IsEmpty() && cell_x2->IsEmpty()) &&
-						(cell_x1->GetMarking().IsMarked(n) && cell_x2->GetMarking().IsMarked(n))) {
-						cell_x1->GetMarking().Erase(n);
-						cell_x2->GetMarking().Erase(n);
-						solved = true;
+		return false;
+	}
+
+	// Solve the candidates by simple coloring. A segment where a number has two positions is a conjugate pair,
+	// one of the two cells holds the number, and the pairs chain the cells into two alternating colors
+	template <class Dimensions>
+	bool BasicGrid<Dimensions>::SolveSimpleColoring() {
+		for (UShort n=1; n<=NUM_BASE; n++) {
+			// Colors of the cells, 0 when not colored yet and then an even and an odd color for each chain
+			array<UShort, NUM_GRID_CELLS> colors;
+			colors.fill(0);
+			UShort chain_color = 2;
+
+			for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+				if (colors[cell] == 0 && state_.GetMarking(cell).IsMarked(n)) {
+					if (SolveColorChain(n, cell, colors, chain_color)) {
+						return true;
 					}
+					chain_color += 2;
 				}
+			}
+		}
 
-				if (!solved) {
-					// Erase the outlying candidates in the columns which intersect the X Wing
-					for (UShort column=0; column<GRID_WIDTH; column++) {
-						if (column == x1 || column == x2) {
-							continue;
-						}
-						auto cell_y1 = (*columns_[column])[y1].lock();
-						auto cell_y2 = (*columns_[column])[y2].lock();
-						if ((cell_y1->IsEmpty() && cell_y2->IsEmpty()) &&
-							(cell_y1->GetMarking().IsMarked(n) && cell_y2->GetMarking().IsMarked(n))) {
-							cell_y1->GetMarking().Erase(n);
-							cell_y2->GetMarking().Erase(n);
+		return false;
+	}
+
+	// Color the chain of conjugate pairs of the number from the cell, with chain_color and chain_color+1.
+	// When two cells of a color see each other the color is false and the number is erased from its cells,
+	// and a cell outside the chain that sees both the colors can not hold the number
+	template <class Dimensions>
+	bool BasicGrid<Dimensions>::SolveColorChain(UShort num, UShort cell, array<UShort, NUM_GRID_CELLS>& colors, UShort chain_color) {
+		using Mask = typename Dimensions::Mask;
+		const auto& layout = GRID_LAYOUT<Dimensions>;
+
+		// The colored cells are also the queue of the breadth first walk
+		array<UShort, NUM_GRID_CELLS> chain;
+		UShort chain_length = 0;
+		chain[chain_length++] = cell;
+		colors[cell] = chain_color;
+		for (UShort next=0; next<chain_length; next++) {
+			auto current = chain[next];
+			for (UShort i=0; i<Dimensions::SEGMENTS_PER_CELL; i++) {
+				auto segment = layout.cell_segments_[current][i];
+				auto positions = state_.GetPositions(segment, num);
+				if (Marking::Bits::GetCount(positions) != 2) {
+					continue;
+				}
+
+				auto other_position = Marking::Bits::GetLowestNumber(static_cast<Mask>(positions & ~(1u << layout.cell_positions_[current][i]))) - 1;
+				auto other = layout.segment_cells_[segment][other_position];
+				if (colors[other] == 0) {
+					colors[other] = colors[current] ^ 1;
+					chain[chain_length++] = other;
+				}
+			}
+		}
+
+		if (chain_length < 2) {
+			return false;
+		}
+
+		// Color wrap, two cells of the same color in a segment
+		for (UShort i=0; i<chain_length; i++) {
+			for (UShort j=i+1; j<chain_length; j++) {
+				if (colors[chain[i]] == colors[chain[j]] && IsPeer<Dimensions>(chain[i], chain[j])) {
+					auto false_color = colors[chain[i]];
+					auto solved = false;
+					for (UShort k=0; k<chain_length; k++) {
+						if (colors[chain[k]] == false_color && state_.EraseCandidate(chain[k], num)) {
 							solved = true;
 						}
 					}
+					return solved;
 				}
 			}
 		}
 
+		// Color trap, a cell outside the chain that sees both the colors
+		auto solved = false;
+		for (UShort trapped=0; trapped<NUM_GRID_CELLS; trapped++) {
+			if ((colors[trapped] | 1) == (chain_color | 1) || !state_.GetMarking(trapped).IsMarked(num)) {
+				continue;
+			}
+
+			UShort seen = 0;
+			for (UShort i=0; i<chain_length && seen != 3; i++) {
+				if (IsPeer<Dimensions>(trapped, chain[i])) {
+					seen |= 1 << (colors[chain[i]] - chain_color);
+				}
+			}
+
+			if (seen == 3 && state_.EraseCandidate(trapped, num)) {
+				solved = true;
+			}
+		}
+
 		return solved;
 	}
+
+    template class BasicGrid<Dimensions6>;
+    template class BasicGrid<Dimensions9>;
+    template class BasicGrid<Dimensions16>;
+    template class BasicGrid<Dimensions25>;
 }
@@ -21,22 +21,76 @@
 #define Grid_h
 
 #include <array>
-#include <memory>
+#include <stdexcept>
+#include <cstring>
+#include <type_traits>
 
 #include "SudokuAlgorithm.h"
-#include "Cell.h"
+#include "GridState.h"
 #include "Row.h"
 #include "Column.h"
 #include "Block.h"
+#include "TechniqueStats.h"
 
 namespace SudokuAlgorithm {
-    class Grid final {
+	// Snapshot of the numbers and candidates of a grid, a fixed size block of plain data
+    template <class Dimensions>
+    using BasicGridSnapshot = BasicGridState<Dimensions>;
+
+    using GridSnapshot = BasicGridSnapshot<Dimensions9>;
+
+	// Logic applies only the solving techniques, and may leave the puzzle incomplete.
+	// Search also guesses the candidates when the techniques stall, and either solves
+	// the puzzle or proves that it has no solution
+    enum class SolveMode {
+        Logic,
+        Search
+    };
+
+	// Grid of the puzzle, with the size of the Dimensions
+    template <class Dimensions>
+    class BasicGrid final {
     public:
-        Grid() : cells_{} {
-            Initialize();
+        using GridState = BasicGridState<Dimensions>;
+        using GridSnapshot = BasicGridSnapshot<Dimensions>;
+        using Marking = BasicMarking<Dimensions>;
+        using Segment = BasicSegment<Dimensions>;
+        using Row = BasicRow<Dimensions>;
+        using Column = BasicColumn<Dimensions>;
+        using Block = BasicBlock<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+        static constexpr UShort NUM_SEGMENTS = Dimensions::NUM_SEGMENTS;
+		// Largest fish searched, 4 base lines for a Jellyfish
+        static constexpr UShort MAX_FISH_SIZE = 4;
+
+        static_assert(std::is_trivially_copyable<GridSnapshot>::value, "grid snapshot is copied as plain data");
+
+        BasicGrid();
+        
+		// Segments refer the state of their own grid, so only the state is copied
+        BasicGrid(const BasicGrid& grid) : BasicGrid() {
+            RestoreSnapshot(grid.state_);
         }
         
-        ~Grid() = default;
+        BasicGrid& operator= (const BasicGrid& grid) {
+            RestoreSnapshot(grid.state_);
+            return *this;
+        }
+        
+        ~BasicGrid() = default;
+        
+		// Save the numbers and candidates of the grid, to branch on a guess
+        void SaveSnapshot(GridSnapshot& snapshot) const {
+            std::memcpy(&snapshot, &state_, sizeof(GridSnapshot));
+        }
+        
+		// Restore the numbers and candidates of the grid saved in the snapshot
+        void RestoreSnapshot(const GridSnapshot& snapshot) {
+            std::memcpy(&state_, &snapshot, sizeof(GridSnapshot));
+        }
         
 		// Get the number in the given cell addressed by its row and column
 		UShort GetCellNumber(UShort row, UShort column) const {
@@ -44,7 +98,7 @@ namespace SudokuAlgorithm {
 				throw std::out_of_range("Grid:: GetCellNumber");
 			}
 
-			return cells_[row*GRID_WIDTH + column]->GetNumber();
+			return state_.GetNumber(row*GRID_WIDTH + column);
 		}
 
         // Set the number to the cell at the given row, column
@@ -54,19 +108,88 @@ namespace SudokuAlgorithm {
         void DisplayGrid() const;
         
         // Solve the puzzle
-        bool Solve();
-		// Solve the candidates by identifying X Wing pattern in the grid
-		bool SolveXWing();
+        bool Solve(SolveMode mode = SolveMode::Search);
+		// Count the solutions of the puzzle by search, stopping once limit solutions are found
+        unsigned long CountSolutions(unsigned long limit);
+		// Solve the candidates by finding X Wing, Swordfish and Jellyfish patterns in the rows and the columns
+		bool SolveFish();
+		// Solve the candidates by finding XY-Wings, a pivot cell with two candidates and two pincers
+		bool SolveXYWing();
+		// Solve the candidates by finding XYZ-Wings, a pivot cell with three candidates and two pincers
+		bool SolveXYZWing();
+		// Solve the candidates by coloring the chains of conjugate pairs of each number
+		bool SolveSimpleColoring();
+
+		// Number of guesses tried by the search in the last solve
+        unsigned long GetSearchNodes() const {
+            return search_nodes_;
+        }
+
+		// Counters of the techniques over all the solves, recorded when SUDOKU_TECHNIQUE_STATS is defined
+        const TechniqueStats& GetTechniqueStats() const {
+            return stats_;
+        }
+
+        void ResetTechniqueStats() {
+            stats_.Reset();
+        }
 
     private:
-        // Allocate the arrays and initialize the cross references
+		// Prepare the candidates and the unsolved numbers of the segments for a solve
         void Initialize();
-        
-        std::array<std::shared_ptr<Cell>, NUM_GRID_CELLS> cells_;
-        std::array<std::shared_ptr<Row>, GRID_WIDTH> rows_;
-        std::array<std::shared_ptr<Column>, GRID_WIDTH> columns_;
-        std::array<std::shared_ptr<Block>, GRID_WIDTH> blocks_;
+		// Apply the solving techniques until the puzzle is solved or no further progress is made
+        bool SolveTechniques();
+		// Solve naked and hidden singles of the whole grid, until none are left
+        bool SolveSingles();
+		// Search the solutions depth first when the techniques stall, true once solution_limit_ are found
+        bool Search();
+		// Find a fish of the size for the number, with the base lines from first_base and the cover lines from first_cover
+        bool SolveFish(UShort num, UShort size, UShort first_base, UShort first_cover);
+		// Color the chain of conjugate pairs of the number from the cell, and erase the number where the colors allow
+        bool SolveColorChain(UShort num, UShort cell, std::array<UShort, NUM_GRID_CELLS>& colors, UShort chain_color);
+
+		// Apply the technique, recording the call in the statistics
+        template <class Function>
+        bool ApplyTechnique(Technique technique, Function solve) {
+            TechniqueScope<GridState> scope(stats_, technique, state_);
+            return solve();
+        }
+
+		// Check that every row is filled
+        bool IsFilled() const {
+            for (const auto& row : rows_) {
+                if (!row.IsFilled()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+		// Numbers and candidates of all the cells, in one block
+        GridState state_;
+
+		// Rows, columns and blocks refer the cells in the state by index
+        std::array<Row, GRID_WIDTH> rows_;
+        std::array<Column, GRID_WIDTH> columns_;
+        std::array<Block, GRID_WIDTH> blocks_;
+		// Rows, columns and blocks by their segment index in the grid state
+        std::array<Segment*, NUM_SEGMENTS> segments_;
+
+        unsigned long search_nodes_ = 0;
+		// Solutions found by the search, which stops when it reaches the limit
+        unsigned long solution_count_ = 0;
+        unsigned long solution_limit_ = 1;
+        TechniqueStats stats_;
     };
+
+    template <class Dimensions> constexpr UShort BasicGrid<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicGrid<Dimensions>::NUM_BASE;
+    template <class Dimensions> constexpr UShort BasicGrid<Dimensions>::NUM_GRID_CELLS;
+    template <class Dimensions> constexpr UShort BasicGrid<Dimensions>::NUM_SEGMENTS;
+    template <class Dimensions> constexpr UShort BasicGrid<Dimensions>::MAX_FISH_SIZE;
+
+    using Grid = BasicGrid<Dimensions9>;
 }
 
 #endif /* Grid_h */
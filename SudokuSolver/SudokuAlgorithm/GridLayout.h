@@ -0,0 +1,124 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  GridLayout.h
+//  SudokuAlgorithm
+//
+
+#ifndef GridLayout_h
+#define GridLayout_h
+
+#include "SudokuAlgorithm.h"
+
+namespace SudokuAlgorithm {
+	// Index tables that map the rows, columns and blocks to the cells of the grid
+    template <class Dimensions>
+    struct GridLayout final {
+		// Cells that share a row, column or block with a cell
+        static constexpr UShort NUM_PEERS = 2*(Dimensions::GRID_WIDTH - 1) +
+            (Dimensions::BOX_ROWS - 1)*(Dimensions::BOX_COLUMNS - 1);
+
+		// Cells of each segment, in the order of their position in the segment
+        UShort segment_cells_[Dimensions::NUM_SEGMENTS][Dimensions::GRID_WIDTH];
+		// Row, column and block segments of each cell
+        UShort cell_segments_[Dimensions::NUM_GRID_CELLS][Dimensions::SEGMENTS_PER_CELL];
+		// Position of each cell in its row, column and block
+        UShort cell_positions_[Dimensions::NUM_GRID_CELLS][Dimensions::SEGMENTS_PER_CELL];
+		// Peers of each cell, the cells of its row and column and then the rest of its block
+        UShort cell_peers_[Dimensions::NUM_GRID_CELLS][NUM_PEERS];
+    };
+
+    template <class Dimensions> constexpr UShort GridLayout<Dimensions>::NUM_PEERS;
+
+	// Blocks are numbered in row major order, and so are the cells in a block
+    template <class Dimensions>
+    constexpr GridLayout<Dimensions> MakeGridLayout() {
+        using D = Dimensions;
+        GridLayout<D> layout{};
+
+        for (UShort cell=0; cell<D::NUM_GRID_CELLS; cell++) {
+            UShort row = cell/D::GRID_WIDTH;
+            UShort column = cell%D::GRID_WIDTH;
+            UShort block = (row/D::BOX_ROWS)*(D::GRID_WIDTH/D::BOX_COLUMNS) + column/D::BOX_COLUMNS;
+            UShort block_position = (row%D::BOX_ROWS)*D::BOX_COLUMNS + column%D::BOX_COLUMNS;
+
+            layout.segment_cells_[D::FIRST_ROW + row][column] = cell;
+            layout.segment_cells_[D::FIRST_COLUMN + column][row] = cell;
+            layout.segment_cells_[D::FIRST_BLOCK + block][block_position] = cell;
+
+            layout.cell_segments_[cell][0] = D::FIRST_ROW + row;
+            layout.cell_segments_[cell][1] = D::FIRST_COLUMN + column;
+            layout.cell_segments_[cell][2] = D::FIRST_BLOCK + block;
+
+            layout.cell_positions_[cell][0] = column;
+            layout.cell_positions_[cell][1] = row;
+            layout.cell_positions_[cell][2] = block_position;
+        }
+
+        for (UShort cell=0; cell<D::NUM_GRID_CELLS; cell++) {
+            auto row = layout.cell_segments_[cell][0];
+            auto column = layout.cell_segments_[cell][1];
+            UShort num_peers = 0;
+            for (UShort position=0; position<D::GRID_WIDTH; position++) {
+                auto row_peer = layout.segment_cells_[row][position];
+                auto column_peer = layout.segment_cells_[column][position];
+                if (row_peer != cell) {
+                    layout.cell_peers_[cell][num_peers++] = row_peer;
+                }
+                if (column_peer != cell) {
+                    layout.cell_peers_[cell][num_peers++] = column_peer;
+                }
+            }
+            for (auto block_peer : layout.segment_cells_[layout.cell_segments_[cell][2]]) {
+                if (layout.cell_segments_[block_peer][0] != row && layout.cell_segments_[block_peer][1] != column) {
+                    layout.cell_peers_[cell][num_peers++] = block_peer;
+                }
+            }
+        }
+
+        return layout;
+    }
+
+    template <class Dimensions>
+    constexpr GridLayout<Dimensions> GRID_LAYOUT = MakeGridLayout<Dimensions>();
+
+	// Index of the row, column and block of a cell
+    template <class Dimensions>
+    constexpr UShort GetCellRow(UShort cell) {
+        return cell/Dimensions::GRID_WIDTH;
+    }
+
+    template <class Dimensions>
+    constexpr UShort GetCellColumn(UShort cell) {
+        return cell%Dimensions::GRID_WIDTH;
+    }
+
+    template <class Dimensions>
+    constexpr UShort GetCellBlock(UShort cell) {
+        return GRID_LAYOUT<Dimensions>.cell_segments_[cell][2] - Dimensions::FIRST_BLOCK;
+    }
+
+	// Check if two different cells share a row, column or block
+    template <class Dimensions>
+    constexpr bool IsPeer(UShort cell, UShort other) {
+        return cell != other &&
+            (GRID_LAYOUT<Dimensions>.cell_segments_[cell][0] == GRID_LAYOUT<Dimensions>.cell_segments_[other][0] ||
+             GRID_LAYOUT<Dimensions>.cell_segments_[cell][1] == GRID_LAYOUT<Dimensions>.cell_segments_[other][1] ||
+             GRID_LAYOUT<Dimensions>.cell_segments_[cell][2] == GRID_LAYOUT<Dimensions>.cell_segments_[other][2]);
+    }
+}
+
+#endif /* GridLayout_h */
@@ -0,0 +1,101 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  GridState.cpp
+//  SudokuAlgorithm
+//
+
+#include "GridState.h"
+
+namespace SudokuAlgorithm {
+	// Update solved number to the cell and erase the number from the cells of its row, column and block.
+	// The segments of the cell and of the peers that had the number as a candidate are queued
+    template <class Dimensions>
+    void BasicGridState<Dimensions>::SolveCell(UShort cell, UShort num) {
+        SetNumber(cell, num);
+
+        for (auto segment : GRID_LAYOUT<Dimensions>.cell_segments_[cell]) {
+            unsolved_nums_[segment].Erase(num);
+
+			// Only the peers where the number is still a candidate
+            for (Mask peers = positions_[segment][num - 1]; peers != 0; peers &= peers - 1) {
+                auto position = Marking::Bits::GetLowestNumber(peers) - 1;
+                EraseCandidate(GRID_LAYOUT<Dimensions>.segment_cells_[segment][position], num);
+            }
+        }
+        QueueCellSegments(cell);
+    }
+
+	// Check that no number repeats in a segment, every empty cell has a candidate,
+	// and every number is either solved or a candidate in each segment
+    template <class Dimensions>
+    bool BasicGridState<Dimensions>::IsConsistent() const {
+        for (UShort segment=0; segment<NUM_SEGMENTS; segment++) {
+            Marking numbers;
+            Marking candidates;
+
+            for (auto cell : GRID_LAYOUT<Dimensions>.segment_cells_[segment]) {
+                auto num = numbers_[cell];
+                if (num != 0) {
+                    if (numbers.IsMarked(num)) {
+                        return false;
+                    }
+                    numbers.Mark(num);
+                } else {
+                    if (markings_[cell].IsEmpty()) {
+                        return false;
+                    }
+                    candidates.Mark(markings_[cell]);
+                }
+            }
+
+            numbers.Mark(candidates);
+            if (numbers.GetCount() != Dimensions::NUM_BASE) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+	// Total of the candidates of all the cells
+    template <class Dimensions>
+    unsigned long BasicGridState<Dimensions>::GetCandidateCount() const {
+        unsigned long count = 0;
+        for (const auto& marking : markings_) {
+            count += marking.GetCount();
+        }
+
+        return count;
+    }
+
+	// Number of the cells with a number
+    template <class Dimensions>
+    unsigned long BasicGridState<Dimensions>::GetFilledCount() const {
+        unsigned long count = 0;
+        for (auto num : numbers_) {
+            if (num != 0) {
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    template class BasicGridState<Dimensions6>;
+    template class BasicGridState<Dimensions9>;
+    template class BasicGridState<Dimensions16>;
+    template class BasicGridState<Dimensions25>;
+}
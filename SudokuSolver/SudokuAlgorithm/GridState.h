@@ -0,0 +1,211 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  GridState.h
+//  SudokuAlgorithm
+//
+
+#ifndef GridState_h
+#define GridState_h
+
+#include <array>
+#include <cstdint>
+
+#include "SudokuAlgorithm.h"
+#include "GridLayout.h"
+#include "Marking.h"
+
+namespace SudokuAlgorithm {
+	// Solver state of the cells and segments of the grid, kept in one contiguous block.
+	// The state holds no pointers; rows, columns and blocks address it through the grid layout
+    template <class Dimensions>
+    class BasicGridState final {
+    public:
+        using Marking = BasicMarking<Dimensions>;
+        using Mask = typename Dimensions::Mask;
+
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+        static constexpr UShort NUM_SEGMENTS = Dimensions::NUM_SEGMENTS;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+
+        BasicGridState() : numbers_{}, markings_{}, unsolved_nums_{}, positions_{}, pending_segments_{} {
+        }
+
+        UShort GetNumber(UShort cell) const {
+            return numbers_[cell];
+        }
+
+        bool IsEmpty(UShort cell) const {
+            return numbers_[cell] == 0;
+        }
+
+        const Marking& GetMarking(UShort cell) const {
+            return markings_[cell];
+        }
+
+		// Candidates of all the cells, in cell order
+        const std::array<Marking, NUM_GRID_CELLS>& GetMarkings() const {
+            return markings_;
+        }
+
+		// Numbers not yet solved in the segment
+        Marking& GetUnsolvedNumbers(UShort segment) {
+            return unsolved_nums_[segment];
+        }
+
+        const Marking& GetUnsolvedNumbers(UShort segment) const {
+            return unsolved_nums_[segment];
+        }
+
+		// Positions in the segment where the number is a candidate, bit i for the i-th cell of the segment
+        Mask GetPositions(UShort segment, UShort num) const {
+            return positions_[segment][num - 1];
+        }
+
+		// Add the candidate to the cell, while the segments are initialized
+        void MarkCandidate(UShort cell, UShort num) {
+            if (!markings_[cell].IsMarked(num)) {
+                markings_[cell].Mark(num);
+                UpdatePositions(cell, num, true);
+            }
+        }
+
+		// Erase the candidate from the cell, and queue its segments if it was marked
+        bool EraseCandidate(UShort cell, UShort num) {
+            if (!markings_[cell].IsMarked(num)) {
+                return false;
+            }
+
+            markings_[cell].Erase(num);
+            UpdatePositions(cell, num, false);
+            QueueCellSegments(cell);
+            return true;
+        }
+
+		// Erase the candidates from the cell, unless it would erase all of them,
+		// and queue its segments if any was marked
+        bool EraseCandidates(UShort cell, const Marking& numbers) {
+            auto erased = markings_[cell].MatchSubset(numbers);
+            if (erased == markings_[cell]) {
+                return false;
+            }
+
+            return ErasePositions(cell, erased);
+        }
+
+		// Keep only the given candidates in the cell, and queue its segments if any other was marked
+        bool KeepCandidates(UShort cell, const Marking& numbers) {
+            Marking erased(markings_[cell].GetNumbers() & ~numbers.GetNumbers());
+            return ErasePositions(cell, erased);
+        }
+
+		// Queue all the segments to be examined by the solving techniques
+        void QueueAllSegments() {
+            for (UShort segment=0; segment<NUM_SEGMENTS; segment++) {
+                QueueSegment(segment);
+            }
+        }
+
+		// Take the queued segment with the lowest index, false if none is queued
+        bool NextQueuedSegment(UShort& segment) {
+            for (UShort word=0; word<NUM_PENDING_WORDS; word++) {
+                auto bits = pending_segments_[word];
+                if (bits != 0) {
+					// Bit scan of the wide candidate masks, the lowest bit is number 1
+                    segment = word*32 + MarkingBits<32>::GetLowestNumber(bits) - 1;
+                    pending_segments_[word] = bits & (bits - 1);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+		// Assign number to the cell, without updating its segments
+        void SetNumber(UShort cell, UShort num) {
+            numbers_[cell] = num;
+            if (num != 0) {
+                for (auto n : markings_[cell]) {
+                    UpdatePositions(cell, n, false);
+                }
+                markings_[cell].EraseAll();
+            }
+        }
+
+		// Update solved number to the cell and erase the number from the cells of its row, column and block
+        void SolveCell(UShort cell, UShort num);
+		// Total of the candidates of all the cells
+        unsigned long GetCandidateCount() const;
+		// Number of the cells with a number
+        unsigned long GetFilledCount() const;
+		// Check that no number repeats in a segment, every empty cell has a candidate,
+		// and every number is either solved or a candidate in each segment
+        bool IsConsistent() const;
+
+    private:
+        static constexpr UShort NUM_PENDING_WORDS = (NUM_SEGMENTS + 31)/32;
+
+		// Queue the row, column and block of the cell, after its candidates changed
+        void QueueCellSegments(UShort cell) {
+            for (auto segment : GRID_LAYOUT<Dimensions>.cell_segments_[cell]) {
+                QueueSegment(segment);
+            }
+        }
+
+		// Mark or erase the cell in the positions of the number in its row, column and block
+        void UpdatePositions(UShort cell, UShort num, bool marked) {
+            for (UShort i=0; i<Dimensions::SEGMENTS_PER_CELL; i++) {
+                auto& positions = positions_[GRID_LAYOUT<Dimensions>.cell_segments_[cell][i]][num - 1];
+                auto bit = static_cast<Mask>(1u << GRID_LAYOUT<Dimensions>.cell_positions_[cell][i]);
+                positions = marked ? static_cast<Mask>(positions | bit) : static_cast<Mask>(positions & ~bit);
+            }
+        }
+
+		// Erase the marked candidates of the cell, and queue its segments if there are any
+        bool ErasePositions(UShort cell, const Marking& erased) {
+            if (erased.IsEmpty()) {
+                return false;
+            }
+
+            markings_[cell] = Marking(markings_[cell].GetNumbers() & ~erased.GetNumbers());
+            for (auto n : erased) {
+                UpdatePositions(cell, n, false);
+            }
+            QueueCellSegments(cell);
+            return true;
+        }
+
+        void QueueSegment(UShort segment) {
+            pending_segments_[segment/32] |= std::uint32_t(1) << (segment%32);
+        }
+
+        std::array<UShort, NUM_GRID_CELLS> numbers_;
+        std::array<Marking, NUM_GRID_CELLS> markings_;
+        std::array<Marking, NUM_SEGMENTS> unsolved_nums_;
+		// Positions of each number in each segment, kept with the candidates of the cells
+        std::array<std::array<Mask, NUM_BASE>, NUM_SEGMENTS> positions_;
+		// Segments whose candidates changed since the techniques last examined them, one bit each
+        std::array<std::uint32_t, NUM_PENDING_WORDS> pending_segments_;
+    };
+
+    template <class Dimensions> constexpr UShort BasicGridState<Dimensions>::NUM_GRID_CELLS;
+    template <class Dimensions> constexpr UShort BasicGridState<Dimensions>::NUM_SEGMENTS;
+    template <class Dimensions> constexpr UShort BasicGridState<Dimensions>::NUM_BASE;
+    template <class Dimensions> constexpr UShort BasicGridState<Dimensions>::NUM_PENDING_WORDS;
+
+    using GridState = BasicGridState<Dimensions9>;
+}
+
+#endif /* GridState_h */
@@ -0,0 +1,107 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  MappedFile.cpp
+//  SudokuAlgorithm
+//
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Map the file, throws runtime_error if it can not be opened or mapped
+    MappedFile::MappedFile(const string& path, Access access) {
+#ifdef _WIN32
+        auto flags = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            file_ = nullptr;
+            throw runtime_error("MappedFile: can not open " + path);
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size)) {
+            CloseHandle(file_);
+            throw runtime_error("MappedFile: can not open " + path);
+        }
+
+        size_ = static_cast<size_t>(size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            data_ = mapping_ ? static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (!data_) {
+                if (mapping_) {
+                    CloseHandle(mapping_);
+                }
+                CloseHandle(file_);
+                throw runtime_error("MappedFile: can not map " + path);
+            }
+        }
+#else
+        auto fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("MappedFile: can not open " + path);
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            close(fd);
+            throw runtime_error("MappedFile: can not open " + path);
+        }
+
+        size_ = static_cast<size_t>(status.st_size);
+        if (size_ > 0) {
+            auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                close(fd);
+                throw runtime_error("MappedFile: can not map " + path);
+            }
+
+            madvise(data, size_, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+            data_ = static_cast<const char*>(data);
+        }
+
+		// The mapping stays valid after the file is closed
+        close(fd);
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+#ifdef _WIN32
+        if (data_) {
+            UnmapViewOfFile(data_);
+            CloseHandle(mapping_);
+        }
+        CloseHandle(file_);
+#else
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  MappedFile.h
+//  SudokuAlgorithm
+//
+
+#ifndef MappedFile_h
+#define MappedFile_h
+
+#include <string>
+#include <cstddef>
+
+namespace SudokuAlgorithm {
+	// A file mapped read only in memory, for the puzzle file readers
+    class MappedFile final {
+    public:
+		// How the mapping is going to be read, a hint to the operating system
+        enum class Access {
+            Sequential,
+            Random
+        };
+
+		// Map the file, throws runtime_error if it can not be opened or mapped
+        MappedFile(const std::string& path, Access access);
+        MappedFile(const MappedFile&) = delete; // the data refers the mapping of this object
+        MappedFile& operator= (const MappedFile&) = delete;
+
+        ~MappedFile();
+
+		// Contents of the file, nullptr for an empty file
+        const char* GetData() const {
+            return data_;
+        }
+
+        std::size_t GetSize() const {
+            return size_;
+        }
+
+    private:
+        const char* data_ = nullptr;
+        std::size_t size_ = 0;
+#ifdef _WIN32
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+#endif
+    };
+}
+
+#endif /* MappedFile_h */
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 //
 //  Marking.h
 //  SudokuAlgorithm
@@ -20,91 +21,255 @@
 #ifndef Marking_h
 #define Marking_h
 
+#include <cstdint>
+#include <iterator>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include "SudokuAlgorithm.h"
 
 namespace SudokuAlgorithm {
-    class Marking final {
+	// Largest number of candidates looked up in tables; larger masks use bit operations
+    constexpr UShort MAX_TABLE_BASE = 9;
+
+	// Lookup tables indexed by the candidate mask
+    template <UShort NumBase>
+    struct MarkingTables final {
+        static constexpr std::uint32_t NUM_MARKINGS = NumBase <= MAX_TABLE_BASE ? (1u << NumBase) : 1;
+
+		// Mask of each number, bit n-1 for the number n, 0 for the number 0
+        std::uint32_t number_masks_[NumBase + 1];
+		// Number of candidates in the mask
+        std::uint8_t counts_[NUM_MARKINGS];
+		// Lowest number in the mask, 0 for the empty mask
+        std::uint8_t lowest_numbers_[NUM_MARKINGS];
+		// The number if the mask has a single candidate, otherwise 0
+        std::uint8_t resolved_numbers_[NUM_MARKINGS];
+    };
+
+    template <UShort NumBase>
+    constexpr MarkingTables<NumBase> MakeMarkingTables() {
+        MarkingTables<NumBase> tables{};
+
+        for (UShort n=1; n<=NumBase; n++) {
+            tables.number_masks_[n] = 1u << (n-1);
+        }
+
+        for (std::uint32_t mask=1; mask<MarkingTables<NumBase>::NUM_MARKINGS; mask++) {
+            tables.counts_[mask] = tables.counts_[mask & (mask-1)] + 1;
+
+            UShort n = 1;
+            while ((mask & tables.number_masks_[n]) == 0) {
+                n++;
+            }
+            tables.lowest_numbers_[mask] = static_cast<std::uint8_t>(n);
+            tables.resolved_numbers_[mask] = tables.counts_[mask] == 1 ? static_cast<std::uint8_t>(n) : 0;
+        }
+
+        return tables;
+    }
+
+    template <UShort NumBase>
+    constexpr MarkingTables<NumBase> MARKING_TABLES = MakeMarkingTables<NumBase>();
+
+	// Candidate mask operations, from the tables for up to MAX_TABLE_BASE numbers
+    template <UShort NumBase, bool UseTables = (NumBase <= MAX_TABLE_BASE)>
+    struct MarkingBits final {
+        static UShort GetCount(std::uint32_t mask) {
+            return MARKING_TABLES<NumBase>.counts_[mask];
+        }
+
+        static UShort GetLowestNumber(std::uint32_t mask) {
+            return MARKING_TABLES<NumBase>.lowest_numbers_[mask];
+        }
+
+        static UShort GetResolvedNumber(std::uint32_t mask) {
+            return MARKING_TABLES<NumBase>.resolved_numbers_[mask];
+        }
+    };
+
+	// Wider masks count the bits in parallel and find the lowest bit with the bit scan instruction
+    template <UShort NumBase>
+    struct MarkingBits<NumBase, false> final {
+        static UShort GetCount(std::uint32_t mask) {
+            mask = mask - ((mask >> 1) & 0x55555555u);
+            mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+            return static_cast<UShort>((((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+        }
+
+        static UShort GetLowestNumber(std::uint32_t mask) {
+            if (mask == 0) {
+                return 0;
+            }
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<UShort>(index + 1);
+#else
+            return static_cast<UShort>(__builtin_ctz(mask) + 1);
+#endif
+        }
+
+        static UShort GetResolvedNumber(std::uint32_t mask) {
+            return (mask & (mask - 1)) == 0 ? GetLowestNumber(mask) : 0;
+        }
+    };
+
+	// Set of candidate numbers of a cell or a segment, one bit per number
+    template <class Dimensions>
+    class BasicMarking final {
     public:
-        Marking() : candidates_{0} {
+        using Mask = typename Dimensions::Mask;
+        using Bits = MarkingBits<Dimensions::NUM_BASE>;
+
+		// Mask of all the numbers, bit n-1 for the number n
+        static constexpr Mask ALL_NUMBERS = static_cast<Mask>((std::uint64_t(1) << Dimensions::NUM_BASE) - 1);
+
+		// Mask of the number, bit n-1 for the number n
+        static Mask GetNumberMask(UShort num) {
+            return static_cast<Mask>(MARKING_TABLES<Dimensions::NUM_BASE>.number_masks_[num]);
+        }
+
+		// Iterates the numbers in the marking in increasing order, clearing the lowest bit at each step
+        class Iterator final {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = UShort;
+            using difference_type = int;
+            using pointer = const UShort*;
+            using reference = UShort;
+
+            explicit Iterator(Mask numbers) : numbers_(numbers) {
+            }
+
+            UShort operator* () const {
+                return Bits::GetLowestNumber(numbers_);
+            }
+
+            Iterator& operator++ () {
+                numbers_ &= numbers_ - 1;
+                return *this;
+            }
+
+            bool operator== (const Iterator& it) const {
+                return numbers_ == it.numbers_;
+            }
+
+            bool operator!= (const Iterator& it) const {
+                return numbers_ != it.numbers_;
+            }
+
+        private:
+            Mask numbers_;
+        };
+
+        BasicMarking() : numbers_(0) {
         }
         
-		Marking(UShort n) {
-			candidates_.numbers_ = n;
+		BasicMarking(Mask n) : numbers_(n & ALL_NUMBERS) {
 		}
 
-		Marking(const Marking& m) {
-			candidates_.numbers_ = m.candidates_.numbers_;
-		}
+		BasicMarking(const BasicMarking& m) = default;
         
-        ~Marking() = default;
+        ~BasicMarking() = default;
         
-        void operator= (const Marking& m) {
-            candidates_.numbers_ = m.candidates_.numbers_;
-        }
+        BasicMarking& operator= (const BasicMarking& m) = default;
 
-        bool operator== (const Marking& m) const {
-            return candidates_.numbers_ == m.candidates_.numbers_;
+        bool operator== (const BasicMarking& m) const {
+            return numbers_ == m.numbers_;
         }
         
-		bool operator!= (const Marking& m) const {
-			return candidates_.numbers_ != m.candidates_.numbers_;
+		bool operator!= (const BasicMarking& m) const {
+			return numbers_ != m.numbers_;
 		}
 
         void Mark(UShort num) {
-            candidates_.numbers_ |= (1 << (num-1));
+            numbers_ |= GetNumberMask(num);
         }
         
-		void Mark(const Marking& m) {
-			candidates_.numbers_ |= m.candidates_.numbers_;
+		void Mark(const BasicMarking& m) {
+			numbers_ |= m.numbers_;
 		}
 
         void Erase(UShort num) {
-            candidates_.numbers_ &= ~(1 << (num-1));
+            numbers_ &= ~GetNumberMask(num);
         }
         
         void EraseAll() {
-            candidates_.numbers_ = 0;
+            numbers_ = 0;
         }
         
         bool IsMarked(UShort num) const {
-            return (candidates_.numbers_ & (1 << (num-1))) != 0;
+            return (numbers_ & GetNumberMask(num)) != 0;
         }
         
 		bool IsEmpty() const {
-			return candidates_.numbers_ == 0;
+			return numbers_ == 0;
 		}
 
-        Marking MatchSubset(const Marking& subset) const {
-            return Marking(subset.candidates_.numbers_ & candidates_.numbers_);
+		// Candidates as a mask, bit n-1 for the number n
+		Mask GetNumbers() const {
+			return numbers_;
+		}
+
+        BasicMarking MatchSubset(const BasicMarking& subset) const {
+            return BasicMarking(subset.numbers_ & numbers_);
         }
         
-		void Intersect(const Marking& m) {
-			candidates_.numbers_ &= m.candidates_.numbers_;
+		void Intersect(const BasicMarking& m) {
+			numbers_ &= m.numbers_;
+		}
+
+		// Check that all the candidates are in the given set
+		bool IsSubsetOf(const BasicMarking& m) const {
+			return (numbers_ & ~m.numbers_) == 0;
 		}
 
 		// Count the number of candidates
-        UShort GetCount() const;
-		// Erase the candidates based on the given subset
-        bool Erase(const Marking& subset);
+        UShort GetCount() const {
+            return Bits::GetCount(numbers_);
+        }
+
+		// Erase the candidates based on the given subset, unless it would erase all the candidates
+        bool Erase(const BasicMarking& subset) {
+            Mask n = numbers_ & ~subset.numbers_;
+            if (n != 0 && n != numbers_) {
+                numbers_ = n;
+                return true;
+            }
+
+            return false;
+        }
+
 		// Return the number if only one candidate is present
-        UShort GetResolvedNumber() const;
+        UShort GetResolvedNumber() const {
+            return Bits::GetResolvedNumber(numbers_);
+        }
+
+		// Return the lowest candidate, 0 if there is none
+        UShort GetLowestNumber() const {
+            return Bits::GetLowestNumber(numbers_);
+        }
+
+		// Iterate the candidates in increasing order
+        Iterator begin() const {
+            return Iterator(numbers_);
+        }
+
+        Iterator end() const {
+            return Iterator(0);
+        }
         
     private:
-        union Candidates {
-            struct {
-                UShort one_ : 1;
-                UShort two_ : 1;
-                UShort three_ : 1;
-                UShort four_ : 1;
-                UShort five_ : 1;
-                UShort six_ : 1;
-                UShort seven_ : 1;
-                UShort eight_ : 1;
-                UShort nine_ : 1;
-            };
-            UShort numbers_;
-        } candidates_;
+        Mask numbers_;
     };
+
+    template <class Dimensions>
+    constexpr typename BasicMarking<Dimensions>::Mask BasicMarking<Dimensions>::ALL_NUMBERS;
+
+    using Marking = BasicMarking<Dimensions9>;
 }
 
 #endif /* Marking_h */
@@ -0,0 +1,385 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PackedPuzzles.cpp
+//  SudokuAlgorithm
+//
+
+#include <stdexcept>
+#include <cstring>
+
+#include "PackedPuzzles.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+    namespace {
+        const char MAGIC[8] = {'S', 'U', 'D', 'O', 'K', 'U', 'P', 'K'};
+
+        void PutLittleEndian(unsigned char* data, uint64_t value, size_t size) {
+            for (size_t i=0; i<size; i++) {
+                data[i] = static_cast<unsigned char>(value >> 8*i);
+            }
+        }
+
+        uint64_t GetLittleEndian(const unsigned char* data, size_t size) {
+            uint64_t value = 0;
+            for (size_t i=0; i<size; i++) {
+                value |= static_cast<uint64_t>(data[i]) << 8*i;
+            }
+            return value;
+        }
+
+		// Appends values of a few bits to the data, the lowest bits first
+        class BitPacker final {
+        public:
+            explicit BitPacker(unsigned char* data) : data_(data) {
+            }
+
+            void Put(unsigned value, UShort bits) {
+                bits_ |= static_cast<uint64_t>(value) << count_;
+                count_ += bits;
+                while (count_ >= 8) {
+                    *data_++ = static_cast<unsigned char>(bits_);
+                    bits_ >>= 8;
+                    count_ -= 8;
+                }
+            }
+
+			// Write the bits left over in the last byte
+            void Flush() {
+                if (count_ > 0) {
+                    *data_++ = static_cast<unsigned char>(bits_);
+                    bits_ = 0;
+                    count_ = 0;
+                }
+            }
+
+        private:
+            unsigned char* data_;
+            uint64_t bits_ = 0;
+            UShort count_ = 0;
+        };
+
+		// Takes the values appended by BitPacker, in the same order
+        class BitUnpacker final {
+        public:
+            explicit BitUnpacker(const unsigned char* data) : data_(data) {
+            }
+
+            unsigned Get(UShort bits) {
+                while (count_ < bits) {
+                    bits_ |= static_cast<uint64_t>(*data_++) << count_;
+                    count_ += 8;
+                }
+
+                auto value = static_cast<unsigned>(bits_ & ((uint64_t(1) << bits) - 1));
+                bits_ >>= bits;
+                count_ -= bits;
+                return value;
+            }
+
+        private:
+            const unsigned char* data_;
+            uint64_t bits_ = 0;
+            UShort count_ = 0;
+        };
+
+		// Number of the bits of the mask below the bit
+        UShort CountBitsBelow(uint32_t mask, UShort bit) {
+            UShort count = 0;
+            for (mask &= (uint32_t(1) << bit) - 1; mask != 0; mask &= mask - 1) {
+                count++;
+            }
+            return count;
+        }
+
+		// Bit of the mask with index bits of the mask below it
+        UShort SelectBit(uint32_t mask, unsigned index) {
+            for (; index > 0; index--) {
+                mask &= mask - 1;
+            }
+            UShort bit = 0;
+            for (; (mask & 1) == 0; mask >>= 1) {
+                bit++;
+            }
+            return bit;
+        }
+    }
+
+	// Check whether the file starts with the header of a packed puzzle file, false if it can not be read
+    bool IsPackedPuzzleFile(const string& path) {
+        ifstream in(path, ios::binary);
+        char magic[sizeof(MAGIC)];
+        return in.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+	// Pack the puzzle into PUZZLE_SIZE bytes, false if a cell is out of range
+    template <class Dimensions>
+    bool BasicPackedFormat<Dimensions>::PackPuzzle(const Puzzle& puzzle, unsigned char* data) {
+        BitPacker packer(data);
+        for (auto num : puzzle) {
+            if (num > NUM_BASE) {
+                return false;
+            }
+            packer.Put(num, CELL_BITS);
+        }
+        packer.Flush();
+
+        return true;
+    }
+
+	// Unpack the puzzle from PUZZLE_SIZE bytes, false if a cell is out of range
+    template <class Dimensions>
+    bool BasicPackedFormat<Dimensions>::UnpackPuzzle(const unsigned char* data, Puzzle& puzzle) {
+        BitUnpacker unpacker(data);
+        for (auto& num : puzzle) {
+            num = static_cast<UShort>(unpacker.Get(CELL_BITS));
+            if (num > NUM_BASE) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+	// Pack the solution into SOLUTION_SIZE bytes, false unless every row and column has all the numbers
+    template <class Dimensions>
+    bool BasicPackedFormat<Dimensions>::PackSolution(const Puzzle& solution, unsigned char* data) {
+        const uint32_t ALL_NUMBERS = (uint64_t(1) << NUM_BASE) - 1;
+        uint32_t column_nums[GRID_WIDTH] = {};
+
+        BitPacker packer(data);
+        for (UShort row=0; row<GRID_WIDTH; row++) {
+            uint32_t unused = ALL_NUMBERS;
+            for (UShort column=0; column<GRID_WIDTH; column++) {
+                auto num = solution[row*GRID_WIDTH + column];
+                if (num == 0 || num > NUM_BASE) {
+                    return false;
+                }
+
+                uint32_t bit = uint32_t(1) << (num - 1);
+                if ((unused & bit) == 0 || (column_nums[column] & bit) != 0) {
+                    return false;
+                }
+
+				// The last row is not stored
+                if (row < GRID_WIDTH - 1) {
+                    packer.Put(CountBitsBelow(unused, num - 1), GetBitWidth(GRID_WIDTH - 1 - column));
+                }
+                unused &= ~bit;
+                column_nums[column] |= bit;
+            }
+        }
+        packer.Flush();
+
+        return true;
+    }
+
+	// Unpack the solution from SOLUTION_SIZE bytes, false if the data is not a packed solution
+    template <class Dimensions>
+    bool BasicPackedFormat<Dimensions>::UnpackSolution(const unsigned char* data, Puzzle& solution) {
+        const uint32_t ALL_NUMBERS = (uint64_t(1) << NUM_BASE) - 1;
+        uint32_t column_nums[GRID_WIDTH] = {};
+
+        BitUnpacker unpacker(data);
+        for (UShort row=0; row<GRID_WIDTH - 1; row++) {
+            uint32_t unused = ALL_NUMBERS;
+            for (UShort column=0; column<GRID_WIDTH; column++) {
+                auto choices = GRID_WIDTH - column;
+                auto index = unpacker.Get(GetBitWidth(choices - 1));
+                if (index >= static_cast<unsigned>(choices)) {
+                    return false;
+                }
+
+                auto bit = SelectBit(unused, index);
+                if ((column_nums[column] & (uint32_t(1) << bit)) != 0) {
+                    return false;
+                }
+
+                solution[row*GRID_WIDTH + column] = bit + 1;
+                unused &= ~(uint32_t(1) << bit);
+                column_nums[column] |= uint32_t(1) << bit;
+            }
+        }
+
+		// The last row has the number missing from each column
+        for (UShort column=0; column<GRID_WIDTH; column++) {
+            solution[(GRID_WIDTH - 1)*GRID_WIDTH + column] = SelectBit(ALL_NUMBERS & ~column_nums[column], 0) + 1;
+        }
+
+        return true;
+    }
+
+	// Create the file and write the header, throws runtime_error if it can not be written
+    template <class Dimensions>
+    BasicPackedWriter<Dimensions>::BasicPackedWriter(const string& path, PackedContent content)
+        : path_(path), out_(path, ios::binary | ios::trunc), content_(content) {
+        unsigned char header[PackedFormat::HEADER_SIZE] = {};
+        memcpy(header, MAGIC, sizeof(MAGIC));
+        header[8] = PackedFormat::VERSION;
+        header[9] = static_cast<unsigned char>(Dimensions::BOX_ROWS);
+        header[10] = static_cast<unsigned char>(Dimensions::BOX_COLUMNS);
+        header[11] = static_cast<unsigned char>(content);
+        PutLittleEndian(header + 12, PackedFormat::GetRecordSize(content), 4);
+
+        if (!out_.write(reinterpret_cast<const char*>(header), sizeof(header))) {
+            throw runtime_error("PackedWriter: can not write " + path_);
+        }
+    }
+
+	// Close the file, if it is not already closed
+    template <class Dimensions>
+    BasicPackedWriter<Dimensions>::~BasicPackedWriter() {
+        try {
+            Close();
+        }
+        catch (const runtime_error&) {
+        }
+    }
+
+	// Add a record of the puzzle or the solution, for a file of only one of them.
+	// Throws invalid_argument for a grid that can not be packed, runtime_error if it can not be written
+    template <class Dimensions>
+    void BasicPackedWriter<Dimensions>::Write(const Puzzle& grid) {
+        if (content_ == PackedContent::PuzzlesAndSolutions) {
+            throw logic_error("PackedWriter: the records need a puzzle and a solution");
+        }
+
+        Write(grid, grid);
+    }
+
+	// Add a record of the puzzle and its solution, the parts of them that the content holds
+    template <class Dimensions>
+    void BasicPackedWriter<Dimensions>::Write(const Puzzle& puzzle, const Puzzle& solution) {
+        unsigned char record[PackedFormat::PUZZLE_SIZE + PackedFormat::SOLUTION_SIZE];
+        size_t size = 0;
+        if (content_ != PackedContent::Solutions) {
+            if (!PackedFormat::PackPuzzle(puzzle, record)) {
+                throw invalid_argument("PackedWriter: a number of the puzzle is out of range");
+            }
+            size += PackedFormat::PUZZLE_SIZE;
+        }
+        if (content_ != PackedContent::Puzzles) {
+            if (!PackedFormat::PackSolution(solution, record + size)) {
+                throw invalid_argument("PackedWriter: the solution is not complete");
+            }
+            size += PackedFormat::SOLUTION_SIZE;
+        }
+
+        if (!out_.is_open() || !out_.write(reinterpret_cast<const char*>(record), size)) {
+            throw runtime_error("PackedWriter: can not write " + path_);
+        }
+        count_++;
+    }
+
+	// Write the record count and close the file, throws runtime_error if it can not be written
+    template <class Dimensions>
+    void BasicPackedWriter<Dimensions>::Close() {
+        if (!out_.is_open()) {
+            return;
+        }
+
+        unsigned char count[8];
+        PutLittleEndian(count, count_, sizeof(count));
+        out_.seekp(16);
+        out_.write(reinterpret_cast<const char*>(count), sizeof(count));
+        out_.close();
+        if (!out_) {
+            throw runtime_error("PackedWriter: can not write " + path_);
+        }
+    }
+
+	// Map the file and check its header, throws runtime_error if it is not a packed file of the grid size
+    template <class Dimensions>
+    BasicPackedReader<Dimensions>::BasicPackedReader(const string& path) : file_(path, MappedFile::Access::Random) {
+        auto header = reinterpret_cast<const unsigned char*>(file_.GetData());
+        if (file_.GetSize() < PackedFormat::HEADER_SIZE || memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+            throw runtime_error("PackedReader: not a packed puzzle file " + path);
+        }
+        if (header[8] != PackedFormat::VERSION) {
+            throw runtime_error("PackedReader: unknown version of " + path);
+        }
+        if (header[9] != Dimensions::BOX_ROWS || header[10] != Dimensions::BOX_COLUMNS) {
+            throw runtime_error("PackedReader: puzzles of another size in " + path);
+        }
+
+        content_ = static_cast<PackedContent>(header[11]);
+        if (content_ != PackedContent::Puzzles && content_ != PackedContent::Solutions &&
+            content_ != PackedContent::PuzzlesAndSolutions) {
+            throw runtime_error("PackedReader: unknown content of " + path);
+        }
+
+        record_size_ = static_cast<size_t>(GetLittleEndian(header + 12, 4));
+        auto count = GetLittleEndian(header + 16, 8);
+        if (record_size_ != PackedFormat::GetRecordSize(content_) ||
+            count > (file_.GetSize() - PackedFormat::HEADER_SIZE)/record_size_) {
+            throw runtime_error("PackedReader: damaged header of " + path);
+        }
+
+        count_ = static_cast<size_t>(count);
+        records_ = header + PackedFormat::HEADER_SIZE;
+    }
+
+	// Unpack the puzzle of the record
+    template <class Dimensions>
+    void BasicPackedReader<Dimensions>::GetPuzzle(size_t index, Puzzle& puzzle) const {
+        if (!HasPuzzles()) {
+            throw logic_error("PackedReader: the file has no puzzles");
+        }
+
+        if (!PackedFormat::UnpackPuzzle(GetRecord(index), puzzle)) {
+            throw runtime_error("PackedReader: damaged puzzle " + to_string(index));
+        }
+    }
+
+	// Unpack the solution of the record
+    template <class Dimensions>
+    void BasicPackedReader<Dimensions>::GetSolution(size_t index, Puzzle& solution) const {
+        if (!HasSolutions()) {
+            throw logic_error("PackedReader: the file has no solutions");
+        }
+
+        auto data = GetRecord(index) + (HasPuzzles() ? PackedFormat::PUZZLE_SIZE : 0);
+        if (!PackedFormat::UnpackSolution(data, solution)) {
+            throw runtime_error("PackedReader: damaged solution " + to_string(index));
+        }
+    }
+
+	// Start of the record, throws out_of_range for an index past the records
+    template <class Dimensions>
+    const unsigned char* BasicPackedReader<Dimensions>::GetRecord(size_t index) const {
+        if (index >= count_) {
+            throw out_of_range("PackedReader::GetRecord");
+        }
+
+        return records_ + index*record_size_;
+    }
+
+    template struct BasicPackedFormat<Dimensions6>;
+    template struct BasicPackedFormat<Dimensions9>;
+    template struct BasicPackedFormat<Dimensions16>;
+    template struct BasicPackedFormat<Dimensions25>;
+
+    template class BasicPackedWriter<Dimensions6>;
+    template class BasicPackedWriter<Dimensions9>;
+    template class BasicPackedWriter<Dimensions16>;
+    template class BasicPackedWriter<Dimensions25>;
+
+    template class BasicPackedReader<Dimensions6>;
+    template class BasicPackedReader<Dimensions9>;
+    template class BasicPackedReader<Dimensions16>;
+    template class BasicPackedReader<Dimensions25>;
+}
@@ -0,0 +1,200 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PackedPuzzles.h
+//  SudokuAlgorithm
+//
+
+#ifndef PackedPuzzles_h
+#define PackedPuzzles_h
+
+#include <string>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "MappedFile.h"
+
+namespace SudokuAlgorithm {
+	// What each record of a packed puzzle file holds
+    enum class PackedContent : std::uint8_t {
+        Puzzles = 1,
+        Solutions = 2,
+        PuzzlesAndSolutions = 3
+    };
+
+	// Check whether the file starts with the header of a packed puzzle file, false if it can not be read
+    bool IsPackedPuzzleFile(const std::string& path);
+
+	// Bits that hold the value
+    constexpr UShort GetBitWidth(UShort value) {
+        UShort bits = 0;
+        for (; value != 0; value >>= 1) {
+            bits++;
+        }
+        return bits;
+    }
+
+	// Bits of a packed row of a solution, the i-th cell of the row has width - i choices
+    constexpr UShort GetPackedRowBits(UShort width) {
+        UShort bits = 0;
+        for (UShort choices=1; choices<=width; choices++) {
+            bits += GetBitWidth(choices - 1);
+        }
+        return bits;
+    }
+
+	// Binary layout of the packed puzzle files. The file starts with a header of HEADER_SIZE bytes,
+	// all the fields little endian:
+	//   0   magic "SUDOKUPK"
+	//   8   version, box rows and box columns of the grid, content - one byte each
+	//   12  size of a record in bytes, 4 bytes
+	//   16  number of the records, 8 bytes
+	//   24  reserved, zero
+	// and then the records of the same size, so a record is found by its index. A record has the packed
+	// puzzle, the packed solution or the puzzle followed by the solution.
+	// A puzzle is packed in the fewest bits that hold the numbers 0 to NUM_BASE, 4 bits a cell for 9x9.
+	// A solution is packed denser, as every row is a permutation of the numbers: a cell is stored as the index
+	// of its number among the numbers not yet used in the row, in just enough bits for the choices left.
+	// The last cell of each row and the last row follow from the others, and are not stored
+    template <class Dimensions>
+    struct BasicPackedFormat final {
+        using Puzzle = BasicPuzzle<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+        static constexpr std::uint8_t VERSION = 1;
+        static constexpr std::size_t HEADER_SIZE = 32;
+		// Bits of a cell of a puzzle
+        static constexpr UShort CELL_BITS = GetBitWidth(NUM_BASE);
+		// Bytes of a packed puzzle, 41 for 9x9
+        static constexpr std::size_t PUZZLE_SIZE = (NUM_GRID_CELLS*CELL_BITS + 7)/8;
+		// Bytes of a packed solution, 21 for 9x9
+        static constexpr std::size_t SOLUTION_SIZE = ((GRID_WIDTH - 1)*GetPackedRowBits(GRID_WIDTH) + 7)/8;
+
+		// Bytes of a record of the content
+        static constexpr std::size_t GetRecordSize(PackedContent content) {
+            return (content != PackedContent::Solutions ? PUZZLE_SIZE : 0) +
+                (content != PackedContent::Puzzles ? SOLUTION_SIZE : 0);
+        }
+
+		// Pack the puzzle into PUZZLE_SIZE bytes, false if a cell is out of range
+        static bool PackPuzzle(const Puzzle& puzzle, unsigned char* data);
+		// Unpack the puzzle from PUZZLE_SIZE bytes, false if a cell is out of range
+        static bool UnpackPuzzle(const unsigned char* data, Puzzle& puzzle);
+		// Pack the solution into SOLUTION_SIZE bytes, false unless every row and column has all the numbers
+        static bool PackSolution(const Puzzle& solution, unsigned char* data);
+		// Unpack the solution from SOLUTION_SIZE bytes, false if the data is not a packed solution
+        static bool UnpackSolution(const unsigned char* data, Puzzle& solution);
+    };
+
+	// Writes the puzzles or solutions to a packed puzzle file. The record count in the header
+	// is filled in when the file is closed
+    template <class Dimensions>
+    class BasicPackedWriter final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+        using PackedFormat = BasicPackedFormat<Dimensions>;
+
+		// Create the file and write the header, throws runtime_error if it can not be written
+        BasicPackedWriter(const std::string& path, PackedContent content);
+        BasicPackedWriter(const BasicPackedWriter&) = delete;
+        BasicPackedWriter& operator= (const BasicPackedWriter&) = delete;
+
+		// Close the file, if it is not already closed
+        ~BasicPackedWriter();
+
+		// Add a record of the puzzle or the solution, for a file of only one of them.
+		// Throws invalid_argument for a grid that can not be packed, runtime_error if it can not be written
+        void Write(const Puzzle& grid);
+		// Add a record of the puzzle and its solution, the parts of them that the content holds
+        void Write(const Puzzle& puzzle, const Puzzle& solution);
+
+		// Write the record count and close the file, throws runtime_error if it can not be written
+        void Close();
+
+        std::size_t GetCount() const {
+            return count_;
+        }
+
+    private:
+        std::string path_;
+        std::ofstream out_;
+        PackedContent content_;
+        std::size_t count_ = 0;
+    };
+
+	// Reads the records of a packed puzzle file mapped in memory. Any record can be read by its index,
+	// and the reader does not change, so threads may share it
+    template <class Dimensions>
+    class BasicPackedReader final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+        using PackedFormat = BasicPackedFormat<Dimensions>;
+
+		// Map the file and check its header, throws runtime_error if it is not a packed file of the grid size
+        explicit BasicPackedReader(const std::string& path);
+
+        std::size_t GetCount() const {
+            return count_;
+        }
+
+        PackedContent GetContent() const {
+            return content_;
+        }
+
+        bool HasPuzzles() const {
+            return content_ != PackedContent::Solutions;
+        }
+
+        bool HasSolutions() const {
+            return content_ != PackedContent::Puzzles;
+        }
+
+		// Unpack the puzzle of the record. Throws out_of_range for an index past the records,
+		// logic_error if the file has no puzzles, and runtime_error for a damaged record
+        void GetPuzzle(std::size_t index, Puzzle& puzzle) const;
+		// Unpack the solution of the record, the same way
+        void GetSolution(std::size_t index, Puzzle& solution) const;
+
+    private:
+		// Start of the record, throws out_of_range for an index past the records
+        const unsigned char* GetRecord(std::size_t index) const;
+
+        MappedFile file_;
+        const unsigned char* records_ = nullptr;
+        std::size_t count_ = 0;
+        std::size_t record_size_ = 0;
+        PackedContent content_ = PackedContent::Puzzles;
+    };
+
+    template <class Dimensions> constexpr UShort BasicPackedFormat<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicPackedFormat<Dimensions>::NUM_BASE;
+    template <class Dimensions> constexpr UShort BasicPackedFormat<Dimensions>::NUM_GRID_CELLS;
+    template <class Dimensions> constexpr std::uint8_t BasicPackedFormat<Dimensions>::VERSION;
+    template <class Dimensions> constexpr std::size_t BasicPackedFormat<Dimensions>::HEADER_SIZE;
+    template <class Dimensions> constexpr UShort BasicPackedFormat<Dimensions>::CELL_BITS;
+    template <class Dimensions> constexpr std::size_t BasicPackedFormat<Dimensions>::PUZZLE_SIZE;
+    template <class Dimensions> constexpr std::size_t BasicPackedFormat<Dimensions>::SOLUTION_SIZE;
+
+    using PackedFormat = BasicPackedFormat<Dimensions9>;
+    using PackedWriter = BasicPackedWriter<Dimensions9>;
+    using PackedReader = BasicPackedReader<Dimensions9>;
+}
+
+#endif /* PackedPuzzles_h */
@@ -0,0 +1,236 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PipelineSolver.cpp
+//  SudokuAlgorithm
+//
+
+#include <thread>
+#include <algorithm>
+
+#include "PipelineSolver.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Set up the solvers, one for each hardware thread when num_threads is 0
+    template <class Dimensions>
+    BasicPipelineSolver<Dimensions>::BasicPipelineSolver(Engine engine, unsigned num_threads) :
+        puzzles_(WINDOW_SIZE),
+        results_(WINDOW_SIZE),
+        ready_(new atomic<size_t>[WINDOW_SIZE]),
+        queue_(new BoundedQueue<size_t, WINDOW_SIZE>()),
+        read_count_(0),
+        written_count_(0),
+        reader_done_(false),
+        stopping_(false) {
+        if (num_threads == 0) {
+            num_threads = max(1u, thread::hardware_concurrency());
+        }
+
+        for (unsigned i = 0; i < num_threads; i++) {
+            solvers_.emplace_back(new PuzzleSolver(engine));
+        }
+    }
+
+	// Solve the puzzles of the reader, and write each result in the order of the file
+    template <class Dimensions>
+    size_t BasicPipelineSolver<Dimensions>::Run(PuzzleReader& reader, const Writer& writer) {
+		// A run stopped by an error may leave puzzles in the queue
+        size_t index;
+        while (queue_->TryPop(index)) {
+        }
+
+        for (size_t slot = 0; slot < WINDOW_SIZE; slot++) {
+            ready_[slot].store(0, memory_order_relaxed);
+        }
+        read_count_ = 0;
+        written_count_ = 0;
+        reader_done_ = false;
+        stopping_ = false;
+        error_ = nullptr;
+
+        thread reader_thread(&BasicPipelineSolver::RunReader, this, ref(reader));
+        vector<thread> workers;
+        for (auto& solver : solvers_) {
+            workers.emplace_back(&BasicPipelineSolver::RunWorker, this, ref(*solver));
+        }
+
+		// Write the slots in order as they become ready
+        size_t solved_count = 0;
+        for (index = 0; !stopping_; index++) {
+            auto slot = index % WINDOW_SIZE;
+            if (ready_[slot].load(memory_order_acquire) != index + 1) {
+                Wait(result_ready_, [&] {
+                    return ready_[slot].load(memory_order_acquire) == index + 1 || stopping_ ||
+                           (reader_done_.load(memory_order_acquire) && index == read_count_.load(memory_order_acquire));
+                });
+            }
+            if (ready_[slot].load(memory_order_acquire) != index + 1) {
+                break;
+            }
+
+            try {
+                writer(index, puzzles_[slot], results_[slot]);
+            }
+            catch (...) {
+                SetError(current_exception());
+                break;
+            }
+            if (results_[slot].solved) {
+                solved_count++;
+            }
+            written_count_.store(index + 1, memory_order_release);
+            Notify(window_free_, false);
+        }
+
+        Stop();
+        reader_thread.join();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (error_) {
+            rethrow_exception(error_);
+        }
+
+        return solved_count;
+    }
+
+	// Read the puzzles into the window, waiting while the window is full
+    template <class Dimensions>
+    void BasicPipelineSolver<Dimensions>::RunReader(PuzzleReader& reader) {
+        try {
+            PuzzleView puzzle;
+            for (size_t index = 0; !stopping_ && reader.Next(puzzle); index++) {
+                if (index - written_count_.load(memory_order_acquire) >= WINDOW_SIZE) {
+                    Wait(window_free_, [&] {
+                        return index - written_count_.load(memory_order_acquire) < WINDOW_SIZE || stopping_;
+                    });
+                }
+
+				// The window holds no more puzzles than the queue, so the push always finds room
+                puzzles_[index % WINDOW_SIZE] = puzzle;
+                queue_->TryPush(index);
+                read_count_.store(index + 1, memory_order_release);
+                Notify(work_ready_, false);
+            }
+        }
+        catch (...) {
+            SetError(current_exception());
+        }
+
+		// The workers finish the queue and the writer stops after the last puzzle read
+        reader_done_.store(true, memory_order_release);
+        Notify(work_ready_, true);
+        Notify(result_ready_, false);
+    }
+
+	// Solve the puzzles of the queue into their slots, until the reader is done and the queue is empty
+    template <class Dimensions>
+    void BasicPipelineSolver<Dimensions>::RunWorker(PuzzleSolver& solver) {
+        try {
+            while (!stopping_) {
+                size_t index;
+                if (!queue_->TryPop(index)) {
+                    auto popped = false;
+                    Wait(work_ready_, [&] {
+                        popped = queue_->TryPop(index);
+                        return popped || reader_done_.load(memory_order_acquire) || stopping_;
+                    });
+					// The reader pushed its last puzzle before it was done, so the queue is checked once more
+                    if (!popped && (stopping_ || !queue_->TryPop(index))) {
+                        return;
+                    }
+                }
+
+                auto slot = index % WINDOW_SIZE;
+                solver.Solve(puzzles_[slot], results_[slot]);
+                ready_[slot].store(index + 1, memory_order_release);
+                Notify(result_ready_, false);
+            }
+        }
+        catch (...) {
+            SetError(current_exception());
+        }
+    }
+
+	// Keep the first error of a thread, and stop the others
+    template <class Dimensions>
+    void BasicPipelineSolver<Dimensions>::SetError(exception_ptr error) {
+        {
+            lock_guard<mutex> lock(mutex_);
+            if (!error_) {
+                error_ = error;
+            }
+        }
+        Stop();
+    }
+
+	// Stop the stages, and wake all the waiting threads
+    template <class Dimensions>
+    void BasicPipelineSolver<Dimensions>::Stop() {
+        stopping_ = true;
+        Notify(work_ready_, true);
+        Notify(result_ready_, true);
+        Notify(window_free_, true);
+    }
+
+	// Wait until the predicate holds, checked under the lock. The waiter is counted before the predicate
+	// is checked, and the fence orders the count before the loads of the predicate
+    template <class Dimensions>
+    template <class Predicate>
+    void BasicPipelineSolver<Dimensions>::Wait(WaitCondition& waiting, Predicate ready) {
+        unique_lock<mutex> lock(mutex_);
+        waiting.waiters.fetch_add(1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        waiting.condition.wait(lock, ready);
+        waiting.waiters.fetch_sub(1, memory_order_relaxed);
+    }
+
+	// Wake the threads waiting on the condition, after the state they wait for changed. With the fences
+	// of both sides, either a waiter sees the change in its predicate, or it is counted here and this
+	// takes the lock, which it holds until it waits, to wake it. Without waiters no lock is taken
+    template <class Dimensions>
+    void BasicPipelineSolver<Dimensions>::Notify(WaitCondition& waiting, bool all) {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (waiting.waiters.load(memory_order_relaxed) == 0) {
+            return;
+        }
+
+        lock_guard<mutex> lock(mutex_);
+        if (all) {
+            waiting.condition.notify_all();
+        } else {
+            waiting.condition.notify_one();
+        }
+    }
+
+	// Counters of the techniques of all the workers, recorded when SUDOKU_TECHNIQUE_STATS is defined
+    template <class Dimensions>
+    TechniqueStats BasicPipelineSolver<Dimensions>::GetTechniqueStats() const {
+        TechniqueStats stats;
+        for (const auto& solver : solvers_) {
+            stats += solver->GetTechniqueStats();
+        }
+
+        return stats;
+    }
+
+    template class BasicPipelineSolver<Dimensions6>;
+    template class BasicPipelineSolver<Dimensions9>;
+    template class BasicPipelineSolver<Dimensions16>;
+    template class BasicPipelineSolver<Dimensions25>;
+}
@@ -0,0 +1,128 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PipelineSolver.h
+//  SudokuAlgorithm
+//
+
+#ifndef PipelineSolver_h
+#define PipelineSolver_h
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <cstddef>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "PuzzleReader.h"
+#include "PuzzleSolver.h"
+#include "BoundedQueue.h"
+#include "TechniqueStats.h"
+
+namespace SudokuAlgorithm {
+	// Solves the puzzles of a file in three overlapped stages: a reader thread parses the puzzles,
+	// the worker threads solve them, and the calling thread writes the results in the order of the file.
+	// The puzzles in flight are kept in a window of slots; a worker solves into the slot of its puzzle,
+	// and the writer takes the slots in order, so the window is also the reorder buffer. A stage with
+	// nothing to do waits on a condition variable until the stage it depends on wakes it; while no stage
+	// waits, the puzzles pass through the queue and the slots without taking the lock
+    template <class Dimensions>
+    class BasicPipelineSolver final {
+    public:
+        using PuzzleView = BasicPuzzleView<Dimensions>;
+        using PuzzleReader = BasicPuzzleReader<Dimensions>;
+        using SolveResult = BasicSolveResult<Dimensions>;
+        using PuzzleSolver = BasicPuzzleSolver<Dimensions>;
+		// Called with the index in the file, the puzzle and its result, in the order of the file
+        using Writer = std::function<void(std::size_t index, const PuzzleView& puzzle, const SolveResult& result)>;
+
+		// Puzzles in flight between the reader and the writer
+        static constexpr std::size_t WINDOW_SIZE = 1024;
+
+		// Set up the solvers, one for each hardware thread when num_threads is 0
+        explicit BasicPipelineSolver(Engine engine = Engine::Search, unsigned num_threads = 0);
+        BasicPipelineSolver(const BasicPipelineSolver&) = delete;
+        BasicPipelineSolver& operator= (const BasicPipelineSolver&) = delete;
+
+        ~BasicPipelineSolver() = default;
+
+        unsigned GetThreadCount() const {
+            return static_cast<unsigned>(solvers_.size());
+        }
+
+		// Solve the puzzles of the reader, and write each result in the order of the file.
+		// Returns the number of puzzles solved; an error of the reader or the writer is rethrown
+        std::size_t Run(PuzzleReader& reader, const Writer& writer);
+
+		// Counters of the techniques of all the workers, recorded when SUDOKU_TECHNIQUE_STATS is defined
+        TechniqueStats GetTechniqueStats() const;
+
+    private:
+		// Condition a stage waits on, with the count of the threads waiting, so that the other stages
+		// take the lock to wake them only when one is waiting
+        struct WaitCondition {
+            std::condition_variable condition;
+            std::atomic<unsigned> waiters{0};
+        };
+
+		// Read the puzzles into the window, waiting while the window is full
+        void RunReader(PuzzleReader& reader);
+		// Solve the puzzles of the queue into their slots, until the reader is done and the queue is empty
+        void RunWorker(PuzzleSolver& solver);
+		// Keep the first error of a thread, and stop the others
+        void SetError(std::exception_ptr error);
+		// Stop the stages, and wake all the waiting threads
+        void Stop();
+		// Wait until the predicate holds, checked under the lock
+        template <class Predicate>
+        void Wait(WaitCondition& waiting, Predicate ready);
+		// Wake the threads waiting on the condition, after the state they wait for changed
+        void Notify(WaitCondition& waiting, bool all);
+
+        std::vector<std::unique_ptr<PuzzleSolver>> solvers_;
+
+		// Slots of the window, for the puzzle at index i in slot i % WINDOW_SIZE. A slot is ready
+		// when its sequence is one past the index of the puzzle solved into it
+        std::vector<PuzzleView> puzzles_;
+        std::vector<SolveResult> results_;
+        std::unique_ptr<std::atomic<std::size_t>[]> ready_;
+		// Indexes of the puzzles read, waiting for a worker
+        std::unique_ptr<BoundedQueue<std::size_t, WINDOW_SIZE>> queue_;
+
+        std::atomic<std::size_t> read_count_;
+        std::atomic<std::size_t> written_count_;
+        std::atomic<bool> reader_done_;
+        std::atomic<bool> stopping_;
+
+		// Guards the waits and the error. The workers wait for puzzles in the queue, the writer for
+		// the next slot to be ready, and the reader for room in the window
+        std::mutex mutex_;
+        WaitCondition work_ready_;
+        WaitCondition result_ready_;
+        WaitCondition window_free_;
+        std::exception_ptr error_;
+    };
+
+    template <class Dimensions> constexpr std::size_t BasicPipelineSolver<Dimensions>::WINDOW_SIZE;
+
+    using PipelineSolver = BasicPipelineSolver<Dimensions9>;
+}
+
+#endif /* PipelineSolver_h */
@@ -0,0 +1,75 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  Puzzle.h
+//  SudokuAlgorithm
+//
+
+#ifndef Puzzle_h
+#define Puzzle_h
+
+#include <array>
+
+#include "SudokuAlgorithm.h"
+
+namespace SudokuAlgorithm {
+	// Numbers of the cells in row major order, 0 for an empty cell
+    template <class Dimensions>
+    using BasicPuzzle = std::array<UShort, Dimensions::NUM_GRID_CELLS>;
+
+    using Puzzle = BasicPuzzle<Dimensions9>;
+
+	// View of a puzzle in the text of a puzzle file, rows of GRID_WIDTH characters
+	// row_stride apart. Digits 1 to 9 and then letters from 'A' are numbers; '0', '.' or 'X' are empty cells
+    template <class Dimensions>
+    class BasicPuzzleView final {
+    public:
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+
+        BasicPuzzleView() : data_(nullptr), row_stride_(GRID_WIDTH) {
+        }
+
+        BasicPuzzleView(const char* data, UShort row_stride) : data_(data), row_stride_(row_stride) {
+        }
+
+		// Number in the cell, 0 for an empty cell
+        UShort operator[] (UShort cell) const {
+            auto num = GetCharNumber(data_[(cell/GRID_WIDTH)*row_stride_ + cell%GRID_WIDTH]);
+            return num <= NUM_BASE ? num : 0;
+        }
+
+		// Copy the numbers to the puzzle
+        void CopyTo(BasicPuzzle<Dimensions>& puzzle) const {
+            for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+                puzzle[cell] = (*this)[cell];
+            }
+        }
+
+    private:
+        const char* data_;
+        UShort row_stride_;
+    };
+
+    template <class Dimensions> constexpr UShort BasicPuzzleView<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicPuzzleView<Dimensions>::NUM_BASE;
+    template <class Dimensions> constexpr UShort BasicPuzzleView<Dimensions>::NUM_GRID_CELLS;
+
+    using PuzzleView = BasicPuzzleView<Dimensions9>;
+}
+
+#endif /* Puzzle_h */
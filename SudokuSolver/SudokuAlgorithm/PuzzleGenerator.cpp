@@ -0,0 +1,157 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PuzzleGenerator.cpp
+//  SudokuAlgorithm
+//
+
+#include <algorithm>
+#include <array>
+
+#include "PuzzleGenerator.h"
+#include "GridLayout.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Fill the grid with a random complete solution. Random numbers are placed in random cells
+	// where they do not repeat, and the dancing links complete the grid, starting over if they can not
+    template <class Dimensions>
+    void BasicPuzzleGenerator<Dimensions>::FillGrid(Puzzle& grid) {
+        using Mask = typename Dimensions::Mask;
+
+        array<UShort, NUM_GRID_CELLS> cells;
+        for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+            cells[cell] = cell;
+        }
+
+        for (;;) {
+            grid.fill(0);
+            shuffle(begin(cells), end(cells), random_);
+
+			// Numbers used in each row, column and block
+            array<Mask, Dimensions::NUM_SEGMENTS> used{};
+            for (UShort i=0; i<NUM_GRID_CELLS/8; i++) {
+                auto cell = cells[i];
+                const auto& segments = GRID_LAYOUT<Dimensions>.cell_segments_[cell];
+                Mask allowed = static_cast<Mask>(~(used[segments[0]] | used[segments[1]] | used[segments[2]]));
+
+                array<UShort, NUM_BASE> nums;
+                UShort num_allowed = 0;
+                for (UShort n=1; n<=NUM_BASE; n++) {
+                    if (allowed & (1u << (n - 1))) {
+                        nums[num_allowed++] = n;
+                    }
+                }
+                if (num_allowed == 0) {
+                    continue;
+                }
+
+                auto num = nums[uniform_int_distribution<UShort>(0, num_allowed - 1)(random_)];
+                grid[cell] = num;
+                for (auto segment : segments) {
+                    used[segment] |= static_cast<Mask>(1u << (num - 1));
+                }
+            }
+
+            SetPuzzle(grid);
+            if (dancing_links_.Solve()) {
+                for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+                    grid[cell] = dancing_links_.GetCellNumber(cell/GRID_WIDTH, cell%GRID_WIDTH);
+                }
+                return;
+            }
+        }
+    }
+
+	// Generate a minimal puzzle with a unique solution, and clues of the symmetry
+    template <class Dimensions>
+    void BasicPuzzleGenerator<Dimensions>::Generate(Puzzle& puzzle, Symmetry symmetry) {
+        FillGrid(puzzle);
+        Minimize(puzzle, symmetry);
+    }
+
+	// Remove the clues of the puzzle while its solution stays unique, false if it is not unique to begin with.
+	// A clue and its symmetric cell are removed together, and each pair is tried once in random order.
+	// A pair is tried if either cell is a clue, as the symmetric cell of a clue may be empty in a given puzzle
+    template <class Dimensions>
+    bool BasicPuzzleGenerator<Dimensions>::Minimize(Puzzle& puzzle, Symmetry symmetry) {
+        if (!IsUnique(puzzle)) {
+            return false;
+        }
+
+        array<UShort, NUM_GRID_CELLS> cells;
+        UShort num_cells = 0;
+        for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+            auto symmetric_cell = GetSymmetricCell(cell, symmetry);
+            if (symmetric_cell >= cell && (puzzle[cell] != 0 || puzzle[symmetric_cell] != 0)) {
+                cells[num_cells++] = cell;
+            }
+        }
+        shuffle(begin(cells), begin(cells) + num_cells, random_);
+
+        for (UShort i=0; i<num_cells; i++) {
+            auto cell = cells[i];
+            auto symmetric_cell = GetSymmetricCell(cell, symmetry);
+            auto num = puzzle[cell];
+            auto symmetric_num = puzzle[symmetric_cell];
+
+            puzzle[cell] = 0;
+            puzzle[symmetric_cell] = 0;
+            if (!IsUnique(puzzle)) {
+                puzzle[cell] = num;
+                puzzle[symmetric_cell] = symmetric_num;
+            }
+        }
+
+        return true;
+    }
+
+	// Check that the puzzle has exactly one solution
+    template <class Dimensions>
+    bool BasicPuzzleGenerator<Dimensions>::IsUnique(const Puzzle& puzzle) {
+        uniqueness_checks_++;
+        SetPuzzle(puzzle);
+        return dancing_links_.CountSolutions(2) == 1;
+    }
+
+	// Set the numbers of the puzzle to the dancing links
+    template <class Dimensions>
+    void BasicPuzzleGenerator<Dimensions>::SetPuzzle(const Puzzle& puzzle) {
+        for (UShort i = 0; i < GRID_WIDTH; i++) {
+            for (UShort j = 0; j < GRID_WIDTH; j++) {
+                dancing_links_.UpdateCell(i, j, puzzle[i*GRID_WIDTH + j]);
+            }
+        }
+    }
+
+	// Cell that mirrors the cell in the symmetry, the cell itself for no symmetry
+    template <class Dimensions>
+    UShort BasicPuzzleGenerator<Dimensions>::GetSymmetricCell(UShort cell, Symmetry symmetry) {
+        switch (symmetry) {
+            case Symmetry::Rotational:
+                return NUM_GRID_CELLS - 1 - cell;
+            case Symmetry::Mirror:
+                return cell - cell%GRID_WIDTH + GRID_WIDTH - 1 - cell%GRID_WIDTH;
+            default:
+                return cell;
+        }
+    }
+
+    template class BasicPuzzleGenerator<Dimensions6>;
+    template class BasicPuzzleGenerator<Dimensions9>;
+    template class BasicPuzzleGenerator<Dimensions16>;
+    template class BasicPuzzleGenerator<Dimensions25>;
+}
@@ -0,0 +1,95 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PuzzleGenerator.h
+//  SudokuAlgorithm
+//
+
+#ifndef PuzzleGenerator_h
+#define PuzzleGenerator_h
+
+#include <random>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "DancingLinks.h"
+
+namespace SudokuAlgorithm {
+	// Symmetry of the clues of a generated puzzle. A clue is removed together with its image,
+	// the cell rotated by 180 degrees or mirrored left to right
+    enum class Symmetry {
+        None,
+        Rotational,
+        Mirror
+    };
+
+	// Generates puzzles with a unique solution, on one thread. A random complete grid is filled,
+	// and its clues are removed in random order while the dancing links still find a single solution,
+	// so no clue of the puzzle can be removed at the end
+    template <class Dimensions>
+    class BasicPuzzleGenerator final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+        using DancingLinks = BasicDancingLinks<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+
+        explicit BasicPuzzleGenerator(unsigned long seed = 0) : random_(seed) {
+        }
+
+        BasicPuzzleGenerator(const BasicPuzzleGenerator&) = delete;
+
+        ~BasicPuzzleGenerator() = default;
+
+		// Restart the random numbers, so a puzzle depends only on its seed
+        void Seed(unsigned long seed) {
+            random_.seed(seed);
+        }
+
+		// Fill the grid with a random complete solution
+        void FillGrid(Puzzle& grid);
+		// Generate a minimal puzzle with a unique solution, and clues of the symmetry
+        void Generate(Puzzle& puzzle, Symmetry symmetry = Symmetry::None);
+		// Remove the clues of the puzzle while its solution stays unique, false if it is not unique to begin with
+        bool Minimize(Puzzle& puzzle, Symmetry symmetry = Symmetry::None);
+
+		// Uniqueness checks made since the generator was created
+        unsigned long GetUniquenessChecks() const {
+            return uniqueness_checks_;
+        }
+
+    private:
+		// Check that the puzzle has exactly one solution
+        bool IsUnique(const Puzzle& puzzle);
+		// Set the numbers of the puzzle to the dancing links
+        void SetPuzzle(const Puzzle& puzzle);
+		// Cell that mirrors the cell in the symmetry, the cell itself for no symmetry
+        static UShort GetSymmetricCell(UShort cell, Symmetry symmetry);
+
+        std::mt19937 random_;
+        DancingLinks dancing_links_;
+        unsigned long uniqueness_checks_ = 0;
+    };
+
+    template <class Dimensions> constexpr UShort BasicPuzzleGenerator<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicPuzzleGenerator<Dimensions>::NUM_BASE;
+    template <class Dimensions> constexpr UShort BasicPuzzleGenerator<Dimensions>::NUM_GRID_CELLS;
+
+    using PuzzleGenerator = BasicPuzzleGenerator<Dimensions9>;
+}
+
+#endif /* PuzzleGenerator_h */
@@ -0,0 +1,200 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  PuzzleReader.cpp
+//  SudokuAlgorithm
+//
+
+#include <stdexcept>
+#include <cstring>
+
+#include "PuzzleReader.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+    namespace {
+        template <class Dimensions>
+        bool IsCellChar(char c) {
+            auto num = GetCharNumber(c);
+            return (num > 0 && num <= Dimensions::NUM_BASE) || c == '0' || c == '.' || c == 'x' || c == 'X';
+        }
+
+		// Check that the line is a row of cells, followed by nothing but spaces or tabs
+        template <class Dimensions>
+        bool IsCellRow(const char* line, size_t length, size_t width) {
+            if (length < width) {
+                return false;
+            }
+
+            for (size_t i=0; i<width; i++) {
+                if (!IsCellChar<Dimensions>(line[i])) {
+                    return false;
+                }
+            }
+
+            for (size_t i=width; i<length; i++) {
+                if (line[i] != ' ' && line[i] != '\t') {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+		// Check that the line is a puzzle, which may be followed by a comma and its solution,
+		// as sudoku_pack --unpack writes them. The solution is not read
+        template <class Dimensions>
+        bool IsPuzzleLine(const char* line, size_t length) {
+            const size_t width = Dimensions::NUM_GRID_CELLS;
+            if (IsCellRow<Dimensions>(line, length, width)) {
+                return true;
+            }
+
+            return length > width && line[width] == ',' &&
+                   IsCellRow<Dimensions>(line + width + 1, length - width - 1, width);
+        }
+
+        bool IsGridLine(const char* line, size_t length) {
+            return length >= 4 && memcmp(line, "Grid", 4) == 0;
+        }
+    }
+
+	// Map the file, throws runtime_error if it can not be opened
+    template <class Dimensions>
+    BasicPuzzleReader<Dimensions>::BasicPuzzleReader(const string& path, InvalidPuzzles invalid_puzzles)
+        : file_(path, MappedFile::Access::Sequential), data_(file_.GetData()), size_(file_.GetSize()),
+          invalid_puzzles_(invalid_puzzles) {
+    }
+
+	// Read the next puzzle, false at the end of the file. An invalid puzzle throws runtime_error,
+	// or is skipped with its line number kept
+    template <class Dimensions>
+    bool BasicPuzzleReader<Dimensions>::Next(PuzzleView& puzzle) {
+        for (;;) {
+            const char* error;
+            size_t error_line;
+            auto status = ReadPuzzle(puzzle, error, error_line);
+            if (status != ReadStatus::Invalid) {
+                return status == ReadStatus::Puzzle;
+            }
+
+            if (invalid_puzzles_ == InvalidPuzzles::Throw) {
+                throw runtime_error(string("PuzzleReader: ") + error + " at line " + to_string(error_line));
+            }
+            skipped_lines_.push_back(error_line);
+        }
+    }
+
+	// Read the next puzzle, or the error and the line of an invalid one
+    template <class Dimensions>
+    typename BasicPuzzleReader<Dimensions>::ReadStatus
+    BasicPuzzleReader<Dimensions>::ReadPuzzle(PuzzleView& puzzle, const char*& error, size_t& error_line) {
+        const char* line;
+        size_t length;
+
+        do {
+            if (!ReadLine(line, length)) {
+                return ReadStatus::End;
+            }
+        } while (length == 0);
+
+        if (IsGridLine(line, length)) {
+			// Euler format, the rows are one line break apart
+            const char* first_row = nullptr;
+            size_t row_stride = 0;
+            for (UShort row=0; row<Dimensions::GRID_WIDTH; row++) {
+                auto read = ReadLine(line, length);
+                if (!read || !IsCellRow<Dimensions>(line, length, Dimensions::GRID_WIDTH)) {
+                    error = "invalid puzzle row";
+                } else if (row == 0) {
+                    first_row = line;
+                    continue;
+                } else if (row == 1) {
+                    row_stride = line - first_row;
+                    continue;
+                } else if (static_cast<size_t>(line - first_row) != row*row_stride) {
+                    error = "uneven puzzle rows";
+                } else {
+                    continue;
+                }
+
+				// The next puzzle starts at a "Grid" line, which may be the line that ended this one
+                error_line = line_number_;
+                if (read && IsGridLine(line, length)) {
+                    position_ = line - data_;
+                    line_number_--;
+                }
+                SkipToGridLine();
+                return ReadStatus::Invalid;
+            }
+
+            puzzle = PuzzleView(first_row, static_cast<UShort>(row_stride));
+            return ReadStatus::Puzzle;
+        }
+
+        if (!IsPuzzleLine<Dimensions>(line, length)) {
+            error = "invalid puzzle";
+            error_line = line_number_;
+            return ReadStatus::Invalid;
+        }
+
+        puzzle = PuzzleView(line, Dimensions::GRID_WIDTH);
+        return ReadStatus::Puzzle;
+    }
+
+	// Skip the rest of an invalid puzzle in the Euler format, up to the next "Grid" line
+    template <class Dimensions>
+    void BasicPuzzleReader<Dimensions>::SkipToGridLine() {
+        for (;;) {
+            auto position = position_;
+            const char* line;
+            size_t length;
+            if (!ReadLine(line, length)) {
+                return;
+            }
+            if (IsGridLine(line, length)) {
+                position_ = position;
+                line_number_--;
+                return;
+            }
+        }
+    }
+
+	// Read the next line without its line break, false at the end of the file
+    template <class Dimensions>
+    bool BasicPuzzleReader<Dimensions>::ReadLine(const char*& line, size_t& length) {
+        if (position_ >= size_) {
+            return false;
+        }
+
+        line = data_ + position_;
+        auto end = static_cast<const char*>(memchr(line, '\n', size_ - position_));
+        length = end ? end - line : size_ - position_;
+        position_ += end ? length + 1 : length;
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+
+        line_number_++;
+        return true;
+    }
+
+    template class BasicPuzzleReader<Dimensions6>;
+    template class BasicPuzzleReader<Dimensions9>;
+    template class BasicPuzzleReader<Dimensions16>;
+    template class BasicPuzzleReader<Dimensions25>;
+}
@@ -0,0 +1,94 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  PuzzleReader.h
+//  SudokuAlgorithm
+//
+
+#ifndef PuzzleReader_h
+#define PuzzleReader_h
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "MappedFile.h"
+
+namespace SudokuAlgorithm {
+	// Reads the puzzles of a file mapped in memory, and hands out views of them in place.
+	// The file has one puzzle of NUM_GRID_CELLS characters per line (81 for 9x9), or the Project Euler
+	// format of a "Grid NN" line followed by GRID_WIDTH rows of GRID_WIDTH characters. Empty lines are skipped,
+	// and a line may end with spaces or tabs. A puzzle line may also be followed by a comma and the solution,
+	// which is not read; any other character after the cells makes the puzzle invalid
+    template <class Dimensions>
+    class BasicPuzzleReader final {
+    public:
+        using PuzzleView = BasicPuzzleView<Dimensions>;
+
+		// Throw runtime_error on an invalid puzzle, or skip it and keep its line number
+        enum class InvalidPuzzles {
+            Throw,
+            Skip
+        };
+
+		// Map the file, throws runtime_error if it can not be opened
+        explicit BasicPuzzleReader(const std::string& path, InvalidPuzzles invalid_puzzles = InvalidPuzzles::Throw);
+        BasicPuzzleReader(const BasicPuzzleReader&) = delete; // views refer the mapping of this object
+        BasicPuzzleReader& operator= (const BasicPuzzleReader&) = delete;
+
+		// Read the next puzzle, false at the end of the file. An invalid puzzle throws runtime_error or is
+		// skipped, as set for the reader. The view is valid as long as the reader
+        bool Next(PuzzleView& puzzle);
+
+		// Line of the file last read
+        std::size_t GetLineNumber() const {
+            return line_number_;
+        }
+
+		// Lines of the invalid puzzles skipped so far
+        const std::vector<std::size_t>& GetSkippedLines() const {
+            return skipped_lines_;
+        }
+
+    private:
+        enum class ReadStatus {
+            Puzzle,
+            End,
+            Invalid
+        };
+
+		// Read the next puzzle, or the error and the line of an invalid one
+        ReadStatus ReadPuzzle(PuzzleView& puzzle, const char*& error, std::size_t& error_line);
+		// Skip the rest of an invalid puzzle in the Euler format, up to the next "Grid" line
+        void SkipToGridLine();
+		// Read the next line without its line break, false at the end of the file
+        bool ReadLine(const char*& line, std::size_t& length);
+
+        MappedFile file_;
+        const char* data_;
+        std::size_t size_;
+        std::size_t position_ = 0;
+        std::size_t line_number_ = 0;
+        InvalidPuzzles invalid_puzzles_;
+        std::vector<std::size_t> skipped_lines_;
+    };
+
+    using PuzzleReader = BasicPuzzleReader<Dimensions9>;
+}
+
+#endif /* PuzzleReader_h */
@@ -0,0 +1,145 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  PuzzleSolver.cpp
+//  SudokuAlgorithm
+//
+
+#include "PuzzleSolver.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+    template <class Dimensions>
+    BasicPuzzleSolver<Dimensions>::BasicPuzzleSolver(Engine engine) : engine_(engine) {
+        grid_.SaveSnapshot(empty_grid_);
+    }
+
+	// Solve the puzzle into the result, true if it is solved
+    template <class Dimensions>
+    bool BasicPuzzleSolver<Dimensions>::Solve(const Puzzle& puzzle, SolveResult& result) {
+        return SolvePuzzle(puzzle, result);
+    }
+
+	// Solve the puzzle read in place from the puzzle file
+    template <class Dimensions>
+    bool BasicPuzzleSolver<Dimensions>::Solve(const PuzzleView& puzzle, SolveResult& result) {
+        return SolvePuzzle(puzzle, result);
+    }
+
+	// Count the solutions of the puzzle, stopping once limit solutions are found
+    template <class Dimensions>
+    unsigned long BasicPuzzleSolver<Dimensions>::CountSolutions(const Puzzle& puzzle, unsigned long limit) {
+        SetPuzzle(puzzle, Engine::DancingLinks);
+        return dancing_links_.CountSolutions(limit);
+    }
+
+    template <class Dimensions>
+    unsigned long BasicPuzzleSolver<Dimensions>::CountSolutions(const PuzzleView& puzzle, unsigned long limit) {
+        SetPuzzle(puzzle, Engine::DancingLinks);
+        return dancing_links_.CountSolutions(limit);
+    }
+
+	// Set the numbers of a puzzle of either representation to the grid or the dancing links
+    template <class Dimensions>
+    template <class T>
+    void BasicPuzzleSolver<Dimensions>::SetPuzzle(const T& puzzle, Engine engine) {
+        if (engine == Engine::DancingLinks) {
+            for (UShort i = 0; i < GRID_WIDTH; i++) {
+                for (UShort j = 0; j < GRID_WIDTH; j++) {
+                    dancing_links_.UpdateCell(i, j, puzzle[i*GRID_WIDTH + j]);
+                }
+            }
+            return;
+        }
+
+        grid_.RestoreSnapshot(empty_grid_);
+        for (UShort i = 0; i < GRID_WIDTH; i++) {
+            for (UShort j = 0; j < GRID_WIDTH; j++) {
+                grid_.UpdateCell(i, j, puzzle[i*GRID_WIDTH + j]);
+            }
+        }
+    }
+
+	// Solve a puzzle of either representation, indexed by cell. With a cache, the solution of an equivalent
+	// puzzle is taken from it, and a puzzle that is solved is added to it
+    template <class Dimensions>
+    template <class T>
+    bool BasicPuzzleSolver<Dimensions>::SolvePuzzle(const T& puzzle, SolveResult& result) {
+        if (cache_ == nullptr) {
+            return SolveWithEngine(puzzle, result);
+        }
+
+		// The numbers index the tables of the canonical form, so they are checked before the engine sees them
+        Puzzle numbers;
+        for (UShort cell = 0; cell < Dimensions::NUM_GRID_CELLS; cell++) {
+            numbers[cell] = puzzle[cell];
+            if (numbers[cell] > Dimensions::NUM_BASE) {
+                throw out_of_range("PuzzleSolver::Solve");
+            }
+        }
+
+        if (!canonical_form_.Canonicalize(numbers)) {
+            cache_->Skip();
+            return SolveWithEngine(numbers, result);
+        }
+
+        if (cache_->Find(canonical_form_, result.solution)) {
+            result.solved = true;
+            result.search_nodes = 0;
+            return true;
+        }
+
+        if (SolveWithEngine(numbers, result)) {
+            cache_->Insert(canonical_form_, result.solution);
+        }
+        return result.solved;
+    }
+
+	// Solve the puzzle with the engine
+    template <class Dimensions>
+    template <class T>
+    bool BasicPuzzleSolver<Dimensions>::SolveWithEngine(const T& puzzle, SolveResult& result) {
+        SetPuzzle(puzzle, engine_);
+
+        if (engine_ == Engine::DancingLinks) {
+            result.solved = dancing_links_.Solve();
+            result.search_nodes = dancing_links_.GetSearchNodes();
+            for (UShort i = 0; i < GRID_WIDTH; i++) {
+                for (UShort j = 0; j < GRID_WIDTH; j++) {
+                    result.solution[i*GRID_WIDTH + j] = dancing_links_.GetCellNumber(i, j);
+                }
+            }
+
+            return result.solved;
+        }
+
+        result.solved = grid_.Solve(engine_ == Engine::Logic ? SolveMode::Logic : SolveMode::Search);
+        result.search_nodes = grid_.GetSearchNodes();
+        for (UShort i = 0; i < GRID_WIDTH; i++) {
+            for (UShort j = 0; j < GRID_WIDTH; j++) {
+                result.solution[i*GRID_WIDTH + j] = grid_.GetCellNumber(i, j);
+            }
+        }
+
+        return result.solved;
+    }
+
+    template class BasicPuzzleSolver<Dimensions6>;
+    template class BasicPuzzleSolver<Dimensions9>;
+    template class BasicPuzzleSolver<Dimensions16>;
+    template class BasicPuzzleSolver<Dimensions25>;
+}
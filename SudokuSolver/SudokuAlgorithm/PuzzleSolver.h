@@ -0,0 +1,129 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  PuzzleSolver.h
+//  SudokuAlgorithm
+//
+
+#ifndef PuzzleSolver_h
+#define PuzzleSolver_h
+
+#include <array>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "Grid.h"
+#include "DancingLinks.h"
+#include "TechniqueStats.h"
+#include "CanonicalForm.h"
+#include "SolutionCache.h"
+
+namespace SudokuAlgorithm {
+	// Solving engines - the techniques only, the techniques with search, or dancing links
+    enum class Engine {
+        Logic,
+        Search,
+        DancingLinks
+    };
+
+	// Numbers of the solved puzzle, or as far as the engine could solve it
+    template <class Dimensions>
+    struct BasicSolveResult {
+        BasicPuzzle<Dimensions> solution;
+        bool solved;
+        unsigned long search_nodes;
+    };
+
+    using SolveResult = BasicSolveResult<Dimensions9>;
+
+	// Solving context for one thread. The grid and the dancing links are set up once
+	// and reused for each puzzle, so solvers on different threads share no state
+    template <class Dimensions>
+    class BasicPuzzleSolver final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+        using PuzzleView = BasicPuzzleView<Dimensions>;
+        using SolveResult = BasicSolveResult<Dimensions>;
+        using Grid = BasicGrid<Dimensions>;
+        using GridSnapshot = BasicGridSnapshot<Dimensions>;
+        using DancingLinks = BasicDancingLinks<Dimensions>;
+        using CanonicalForm = BasicCanonicalForm<Dimensions>;
+        using SolutionCache = BasicSolutionCache<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+
+        explicit BasicPuzzleSolver(Engine engine = Engine::Search);
+        BasicPuzzleSolver(const BasicPuzzleSolver&) = delete;
+
+        ~BasicPuzzleSolver() = default;
+
+        Engine GetEngine() const {
+            return engine_;
+        }
+
+		// Counters of the techniques over the puzzles solved, recorded when SUDOKU_TECHNIQUE_STATS is defined
+        const TechniqueStats& GetTechniqueStats() const {
+            return grid_.GetTechniqueStats();
+        }
+
+        void ResetTechniqueStats() {
+            grid_.ResetTechniqueStats();
+        }
+
+		// Look the puzzles up in the cache before solving them, and add their solutions to it.
+		// The cache may be shared by the solvers of several threads; nullptr solves without a cache
+        void SetSolutionCache(SolutionCache* cache) {
+            cache_ = cache;
+        }
+
+		// Solve the puzzle into the result, true if it is solved. A puzzle found in the cache is solved
+		// with no search nodes. Throws out_of_range for a number above the base
+        bool Solve(const Puzzle& puzzle, SolveResult& result);
+		// Solve the puzzle read in place from the puzzle file
+        bool Solve(const PuzzleView& puzzle, SolveResult& result);
+
+		// Count the solutions of the puzzle, stopping once limit solutions are found, so a limit
+		// of 2 tells a unique puzzle from one with several solutions. Every engine counts with the
+		// dancing links, which search the whole tree faster than the techniques do
+        unsigned long CountSolutions(const Puzzle& puzzle, unsigned long limit = 2);
+        unsigned long CountSolutions(const PuzzleView& puzzle, unsigned long limit = 2);
+
+    private:
+		// Set the numbers of a puzzle of either representation to the grid or the dancing links
+        template <class T>
+        void SetPuzzle(const T& puzzle, Engine engine);
+		// Solve a puzzle of either representation, indexed by cell
+        template <class T>
+        bool SolvePuzzle(const T& puzzle, SolveResult& result);
+		// Solve the puzzle with the engine
+        template <class T>
+        bool SolveWithEngine(const T& puzzle, SolveResult& result);
+
+        Engine engine_;
+        Grid grid_;
+		// State of the grid before any puzzle is set, restored for each puzzle
+        GridSnapshot empty_grid_;
+        DancingLinks dancing_links_;
+        SolutionCache* cache_ = nullptr;
+        CanonicalForm canonical_form_;
+    };
+
+    template <class Dimensions> constexpr UShort BasicPuzzleSolver<Dimensions>::GRID_WIDTH;
+
+    using PuzzleSolver = BasicPuzzleSolver<Dimensions9>;
+}
+
+#endif /* PuzzleSolver_h */
@@ -0,0 +1,166 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PuzzleWriter.cpp
+//  SudokuAlgorithm
+//
+
+#include "PuzzleWriter.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Parse the name of an output format - grid, line, csv or none
+    bool ParseOutputFormat(const string& format_str, OutputFormat& format) {
+        if (format_str == "grid") {
+            format = OutputFormat::Grid;
+        } else if (format_str == "line") {
+            format = OutputFormat::Line;
+        } else if (format_str == "csv") {
+            format = OutputFormat::Csv;
+        } else if (format_str == "none") {
+            format = OutputFormat::None;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    template <class Dimensions>
+    BasicPuzzleWriter<Dimensions>::BasicPuzzleWriter(ostream& out, OutputFormat format, Engine engine) :
+        out_(out), format_(format), engine_(engine) {
+        buffer_.reserve(BUFFER_SIZE + 4*NUM_GRID_CELLS);
+
+        for (UShort block=0; block<GRID_WIDTH/Dimensions::BOX_COLUMNS; block++) {
+            row_separator_ += " " + string(2*Dimensions::BOX_COLUMNS - 1, '-');
+        }
+        row_separator_ += " \n";
+
+        if (format_ == OutputFormat::Csv) {
+            buffer_ += "puzzle,numbers,solution,status\n";
+        }
+    }
+
+	// Flush the rest of the text
+    template <class Dimensions>
+    BasicPuzzleWriter<Dimensions>::~BasicPuzzleWriter() {
+        Flush();
+    }
+
+	// Write the result of the puzzle at the index in the batch
+    template <class Dimensions>
+    void BasicPuzzleWriter<Dimensions>::Write(size_t index, const Puzzle& puzzle, const SolveResult& result) {
+        WritePuzzle(index, puzzle, result);
+    }
+
+    template <class Dimensions>
+    void BasicPuzzleWriter<Dimensions>::Write(size_t index, const PuzzleView& puzzle, const SolveResult& result) {
+        WritePuzzle(index, puzzle, result);
+    }
+
+	// Add a line of text, such as a summary, after the results
+    template <class Dimensions>
+    void BasicPuzzleWriter<Dimensions>::WriteLine(const string& line) {
+        buffer_ += line;
+        buffer_ += '\n';
+    }
+
+	// Write the buffered text to the stream
+    template <class Dimensions>
+    void BasicPuzzleWriter<Dimensions>::Flush() {
+        if (!buffer_.empty()) {
+            out_.write(buffer_.data(), buffer_.size());
+            out_.flush();
+            buffer_.clear();
+        }
+    }
+
+	// Write the result of a puzzle of either representation; the puzzles are numbered from 1
+    template <class Dimensions>
+    template <class T>
+    void BasicPuzzleWriter<Dimensions>::WritePuzzle(size_t index, const T& puzzle, const SolveResult& result) {
+        switch (format_) {
+            case OutputFormat::Grid:
+                buffer_ += "PUZZLE: " + to_string(index + 1) + "\n";
+                AppendGrid(puzzle);
+                if (result.solved) {
+                    buffer_ += "\nSolution Successful!\n";
+                } else {
+					// The techniques alone stall on puzzles that do have a solution
+                    buffer_ += engine_ == Engine::Logic ? "\nSolution incomplete!\n" : "\nNo solution!\n";
+                }
+                AppendGrid(result.solution);
+                buffer_ += '\n';
+                break;
+            case OutputFormat::Line:
+                AppendLine(result.solution);
+                buffer_ += '\n';
+                break;
+            case OutputFormat::Csv:
+                buffer_ += to_string(index + 1);
+                buffer_ += ',';
+                AppendLine(puzzle);
+                buffer_ += ',';
+                AppendLine(result.solution);
+                buffer_ += result.solved ? ",solved\n" : ",unsolved\n";
+                break;
+            case OutputFormat::None:
+                break;
+        }
+
+        if (buffer_.size() >= BUFFER_SIZE) {
+            Flush();
+        }
+    }
+
+	// Add the numbers of the puzzle as a grid, with X for the empty cells, as Grid::DisplayGrid shows them
+    template <class Dimensions>
+    template <class T>
+    void BasicPuzzleWriter<Dimensions>::AppendGrid(const T& puzzle) {
+        for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+            auto row = cell/GRID_WIDTH;
+            auto column = cell%GRID_WIDTH;
+
+            if (column == 0 && row % Dimensions::BOX_ROWS == 0) {
+                buffer_ += row_separator_;
+            }
+
+            buffer_ += column % Dimensions::BOX_COLUMNS == 0 ? '|' : ' ';
+            buffer_ += puzzle[cell] == 0 ? 'X' : GetNumberChar(puzzle[cell]);
+
+            if (column == GRID_WIDTH - 1) {
+                buffer_ += "|\n";
+                if (row == GRID_WIDTH - 1) {
+                    buffer_ += row_separator_;
+                }
+            }
+        }
+    }
+
+	// Add the numbers of the puzzle on one line, with 0 for the empty cells
+    template <class Dimensions>
+    template <class T>
+    void BasicPuzzleWriter<Dimensions>::AppendLine(const T& puzzle) {
+        for (UShort cell=0; cell<NUM_GRID_CELLS; cell++) {
+            buffer_ += GetNumberChar(puzzle[cell]);
+        }
+    }
+
+    template class BasicPuzzleWriter<Dimensions6>;
+    template class BasicPuzzleWriter<Dimensions9>;
+    template class BasicPuzzleWriter<Dimensions16>;
+    template class BasicPuzzleWriter<Dimensions25>;
+}
@@ -0,0 +1,107 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  PuzzleWriter.h
+//  SudokuAlgorithm
+//
+
+#ifndef PuzzleWriter_h
+#define PuzzleWriter_h
+
+#include <ostream>
+#include <string>
+#include <cstddef>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "PuzzleSolver.h"
+
+namespace SudokuAlgorithm {
+	// Formats of the results of a batch run. Grid displays the puzzle and its solution as grids,
+	// Line writes the solution on one line, Csv writes a row with the puzzle, the solution and the status,
+	// and None writes nothing for the puzzles
+    enum class OutputFormat {
+        Grid,
+        Line,
+        Csv,
+        None
+    };
+
+	// Parse the name of an output format - grid, line, csv or none
+    bool ParseOutputFormat(const std::string& format_str, OutputFormat& format);
+
+	// Writes the results of a batch run in the output format. The text is collected in a large buffer,
+	// and written to the stream only when the buffer is full or flushed. The engine tells a puzzle
+	// without a solution from one the techniques could not complete
+    template <class Dimensions>
+    class BasicPuzzleWriter final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+        using PuzzleView = BasicPuzzleView<Dimensions>;
+        using SolveResult = BasicSolveResult<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_GRID_CELLS = Dimensions::NUM_GRID_CELLS;
+		// Text collected before it is written to the stream
+        static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+        BasicPuzzleWriter(std::ostream& out, OutputFormat format, Engine engine = Engine::Search);
+        BasicPuzzleWriter(const BasicPuzzleWriter&) = delete;
+        BasicPuzzleWriter& operator= (const BasicPuzzleWriter&) = delete;
+
+		// Flush the rest of the text
+        ~BasicPuzzleWriter();
+
+        OutputFormat GetFormat() const {
+            return format_;
+        }
+
+		// Write the result of the puzzle at the index in the batch
+        void Write(std::size_t index, const Puzzle& puzzle, const SolveResult& result);
+        void Write(std::size_t index, const PuzzleView& puzzle, const SolveResult& result);
+
+		// Add a line of text, such as a summary, after the results
+        void WriteLine(const std::string& line);
+
+		// Write the buffered text to the stream
+        void Flush();
+
+    private:
+		// Write the result of a puzzle of either representation
+        template <class T>
+        void WritePuzzle(std::size_t index, const T& puzzle, const SolveResult& result);
+		// Add the numbers of the puzzle as a grid, with X for the empty cells
+        template <class T>
+        void AppendGrid(const T& puzzle);
+		// Add the numbers of the puzzle on one line, with 0 for the empty cells
+        template <class T>
+        void AppendLine(const T& puzzle);
+
+        std::ostream& out_;
+        OutputFormat format_;
+        Engine engine_;
+        std::string buffer_;
+		// Line between the bands of blocks in the grid format
+        std::string row_separator_;
+    };
+
+    template <class Dimensions> constexpr UShort BasicPuzzleWriter<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicPuzzleWriter<Dimensions>::NUM_GRID_CELLS;
+    template <class Dimensions> constexpr std::size_t BasicPuzzleWriter<Dimensions>::BUFFER_SIZE;
+
+    using PuzzleWriter = BasicPuzzleWriter<Dimensions9>;
+}
+
+#endif /* PuzzleWriter_h */
@@ -18,103 +18,52 @@
 //
 
 #include "Row.h"
+#include "Column.h"
+#include "Block.h"
 
 using namespace std;
 
 namespace SudokuAlgorithm {
 	// Prepares the row for the solution
-	void Row::Initialize() {
+	template <class Dimensions>
+	void BasicRow<Dimensions>::Initialize() {
 		Segment::Initialize();
 
+		const Marking& unsolved_nums = state_.GetUnsolvedNumbers(segment_);
 		// Mark the candidates based on the numbers present in the intersecting columns and blocks
-		for (auto n : unsolved_nums_) {
-			for (auto column = 0; column<cells_.size(); column++) {
-				auto cell = cells_[column].lock();
-				if (cell->IsEmpty()) {
-					if (!column_refs_[column].lock()->FindNumber(n) &&
-						!block_refs_[column/block_refs_.size()].lock()->FindNumber(n)) {
-						cell->GetMarking().Mark(n);
+		for (auto n : unsolved_nums) {
+			for (UShort column=0; column<GRID_WIDTH; column++) {
+				auto cell = cells_[column];
+				if (state_.IsEmpty(cell)) {
+					if (!Column(column, state_).FindNumber(n) &&
+						!Block(GetCellBlock(cell), state_).FindNumber(n)) {
+						state_.MarkCandidate(cell, n);
 					}
 				}
 			}
 		}
 	}
 
-	// Solve visible and hidden singles
-	bool Row::SolveSingles() {
-		bool solved = false;
-		
-		for (auto column=0; column<cells_.size(); column++) {
-			auto cell = cells_[column].lock();
-			Marking& marking = cell->GetMarking();
-			UShort n;
-
-			// Update solved number to the cell if only one candidate is marked for the cell
-			if (cell->IsEmpty() && (n = marking.GetResolvedNumber()) != 0) {
-				*cell = n;
-
-				// Update the solution in the row and the intersecting columns and blocks
-				UpdateSolvedNumber(n);
-				column_refs_[column].lock()->UpdateSolvedNumber(n);
-				block_refs_[column / block_refs_.size()].lock()->UpdateSolvedNumber(n);
-
-				solved = true;
-			}
-		}
-
-		vector<UShort> nums(unsolved_nums_);
-		// Solve hidden single
-		for (UShort n : nums) {
-			UShort mark_col = 0;
-			UShort mark_count = 0;
-
-			// Count the candidate's occurances in the row
-			for (auto column=0; column<cells_.size(); column++) {
-				auto cell = cells_[column].lock();
-				if (cell->IsEmpty()) {
-					if (cell->GetMarking().IsMarked(n)) {
-						mark_col = column;
-						mark_count++;
-						if (mark_count > 1) {
-							break;
-						}
-					}
-				}
-			}
-
-			// Update the solution if a candidate occurs only once in a row
-			if (mark_count == 1) {
-				auto cell = cells_[mark_col].lock();
-				*cell = n;
-				UpdateSolvedNumber(n);
-				column_refs_[mark_col].lock()->UpdateSolvedNumber(n);
-				block_refs_[mark_col / block_refs_.size()].lock()->UpdateSolvedNumber(n);
-
-				solved = true;
-			}
-		}
-
-		return solved;
-	}
-
 	// Solve intersections or pointing pairs
-    bool Row::SolveIntersections() {
+    template <class Dimensions>
+    bool BasicRow<Dimensions>::SolveIntersections() {
         bool solved = false;
         
-        for (auto n : unsolved_nums_) {
-			if (GetCandidateCount(n) > 2) {
+		const Marking& unsolved_nums = state_.GetUnsolvedNumbers(segment_);
+        for (auto n : unsolved_nums) {
+			if (this->GetCandidateCount(n) > 2) {
 				UShort num_count = 0;
 				auto aligned_block = -1;
-				for (auto column=0; column<cells_.size(); column++) {
-					auto cell = cells_[column].lock();
-					if (cell->IsEmpty() && cell->GetMarking().IsMarked(n)) {
+				for (UShort column=0; column<GRID_WIDTH; column++) {
+					auto cell = cells_[column];
+					if (state_.IsEmpty(cell) && state_.GetMarking(cell).IsMarked(n)) {
 						num_count++;
 					}
 					// Find the block intersecting the row in which the candidate is aligned
 					// The block does not have any occurance of the candidate apart from those aligned to this row
-					if ((column + 1) % BLOCK_WIDTH == 0) {
-						if (num_count > 1 && num_count == block_refs_[column / BLOCK_WIDTH].lock()->GetCandidateCount(n)) {
-							aligned_block = column / BLOCK_WIDTH;
+					if ((column + 1) % BOX_COLUMNS == 0) {
+						if (num_count > 1 && num_count == Block(GetCellBlock(cell), state_).GetCandidateCount(n)) {
+							aligned_block = column / BOX_COLUMNS;
 							break;
 						}
 						num_count = 0;
@@ -123,12 +72,10 @@ namespace SudokuAlgorithm {
 
 				if (aligned_block >= 0) {
 					// Erase the candidate occurances in the row which are not aligned in a block
-					for (auto column = 0; column<cells_.size(); column++) {
-						if (column / BLOCK_WIDTH != aligned_block) {
-							auto cell = cells_[column].lock();
-							Marking& marking = cell->GetMarking();
-							if (cell->IsEmpty() && marking.IsMarked(n)) {
-								marking.Erase(n);
+					for (UShort column=0; column<GRID_WIDTH; column++) {
+						if (column / BOX_COLUMNS != aligned_block) {
+							auto cell = cells_[column];
+							if (state_.IsEmpty(cell) && state_.EraseCandidate(cell, n)) {
 								solved = true;
 							}
 						}
@@ -139,4 +86,9 @@ namespace SudokuAlgorithm {
         
         return solved;
     }
+
+    template class BasicRow<Dimensions6>;
+    template class BasicRow<Dimensions9>;
+    template class BasicRow<Dimensions16>;
+    template class BasicRow<Dimensions25>;
 }
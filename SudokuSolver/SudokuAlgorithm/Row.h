@@ -20,47 +20,45 @@
 #ifndef Row_h
 #define Row_h
 
-#include <array>
-#include <memory>
-
 #include "SudokuAlgorithm.h"
 #include "Segment.h"
 
 namespace SudokuAlgorithm {
 	// Row in a Sudoku puzzle grid
-    class Row final : public Segment {
+    template <class Dimensions>
+    class BasicRow final : public BasicSegment<Dimensions> {
     public:
-        Row(UShort index) : Segment(index) {
-        }
-        
-        ~Row() = default;
-        
-		// Add reference to an intersecting column
-        void AddColumnRef(const std::shared_ptr<Segment>& column) {
-            column_refs_[column->GetIndex()] = column;
+        using Segment = BasicSegment<Dimensions>;
+        using GridState = BasicGridState<Dimensions>;
+        using Marking = BasicMarking<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort BOX_COLUMNS = Dimensions::BOX_COLUMNS;
+
+        BasicRow(UShort index, GridState& state) : Segment(index, Dimensions::FIRST_ROW + index, state) {
         }
         
-		// Add reference to an intersecting block
-        void AddBlockRef(const std::shared_ptr<Segment>& block) {
-            if (index_/block_refs_.size() != block->GetIndex()/block_refs_.size()) {
-                throw std::invalid_argument("block");
-            }
-            
-            block_refs_[block->GetIndex()%block_refs_.size()] = block;
-        }
+        ~BasicRow() = default;
         
 		// Prepare the row for the solution
 		virtual void Initialize() override;
-		// Solve visible and hidden singles
-		virtual bool SolveSingles() override;
 		// Solve intersections or pointing pairs
 		virtual bool SolveIntersections() override;
 
     private:
-		// References to the columns and blocks that the row intersects
-        std::array<std::weak_ptr<Segment>, GRID_WIDTH> column_refs_;
-        std::array<std::weak_ptr<Segment>, GRID_WIDTH/BLOCK_WIDTH> block_refs_;
+        using Column = BasicColumn<Dimensions>;
+        using Block = BasicBlock<Dimensions>;
+
+        using Segment::GetCellBlock;
+        using Segment::segment_;
+        using Segment::cells_;
+        using Segment::state_;
     };
+
+    template <class Dimensions> constexpr UShort BasicRow<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicRow<Dimensions>::BOX_COLUMNS;
+
+    using Row = BasicRow<Dimensions9>;
 }
 
 #endif /* Row_h */
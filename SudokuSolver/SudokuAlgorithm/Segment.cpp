@@ -17,214 +17,133 @@
 //  SudokuAlgorithm
 //
 
+#include <stdexcept>
+#include <array>
+
 #include "Segment.h"
+#include "SubsetTables.h"
 
 using namespace std;
 
 namespace SudokuAlgorithm {
 	// Intialize is called to prepare the segment for the solution
-    void Segment::Initialize() {
-        unsolved_nums_.clear();
+    template <class Dimensions>
+    void BasicSegment<Dimensions>::Initialize() {
+        Marking& unsolved_nums = state_.GetUnsolvedNumbers(segment_);
+        unsolved_nums.EraseAll();
         
 		// Add the numbers not present in the cells of the segment 
 		// to the unsolved numbers list
         for (UShort n=1; n<=NUM_BASE; n++) {
-            if (find_if(begin(cells_), end(cells_),
-                    [n](const weak_ptr<Cell>& cell)
-                        { return n == cell.lock()->GetNumber();}) == end(cells_)) {
-                unsolved_nums_.push_back(n);
-            }
-        }
-        
-        if (unsolved_nums_.empty()) {
-            filled_ = true;
-        }
-    }
-    
-	// Count the candidate's marking in a segment
-    UShort Segment::GetCandidateCount(UShort num) const {
-        UShort count = 0;
-        
-        for (auto cell : cells_) {
-            if (cell.lock()->GetMarking().IsMarked(num)) {
-                count++;
+            if (!FindNumber(n)) {
+                unsolved_nums.Mark(n);
             }
         }
-        
-        return count;
     }
     
 	// Refer the cell in a segment
-    weak_ptr<Cell>& Segment::operator[] (UShort index) {
-        if (index >= cells_.size()) {
+    template <class Dimensions>
+    UShort BasicSegment<Dimensions>::operator[] (UShort index) const {
+        if (index >= GRID_WIDTH) {
             throw out_of_range("Segment[]");
 		}
 
 		return cells_[index];
 	}
 
-	// Update the solved number in the segment and its cell markings
-	void Segment::UpdateSolvedNumber(UShort number) {
-		auto itr = find(begin(unsolved_nums_), end(unsolved_nums_), number);
-		if (itr != end(unsolved_nums_)) {
-			unsolved_nums_.erase(itr);
-		}
-		if (unsolved_nums_.empty()) {
-			filled_ = true;
-		}
-
+	// Find if the number is solved in the given segment
+	template <class Dimensions>
+	bool BasicSegment<Dimensions>::FindNumber(UShort number) const {
 		for (auto cell : cells_) {
-			if (cell.lock()->IsEmpty()) {
-				cell.lock()->GetMarking().Erase(number);
+			if (state_.GetNumber(cell) == number) {
+				return true;
 			}
 		}
-	}
 
-	// Find if the number is solved in the given segment
-	bool Segment::FindNumber(UShort number) const {
-		return find_if(begin(cells_), end(cells_),
-					[number](const weak_ptr<Cell>& cell)
-						{ return number == cell.lock()->GetNumber(); }) != end(cells_);
+		return false;
 	}
 
-	// Solve visible pairs, triples, quads etc.,
-	bool Segment::SolveVisibleSubsets() {
+	// Solve visible pairs, triples and quads, checking every combination of the empty cells
+	// that have at most MAX_SUBSET_SIZE candidates
+	template <class Dimensions>
+	bool BasicSegment<Dimensions>::SolveVisibleSubsets() {
+		const auto& tables = SUBSET_TABLES<GRID_WIDTH>;
 		auto solved = false;
 
-		for (UShort i=0; i<GRID_WIDTH; i++) {
-			auto cell = cells_[i].lock();
-			if (!cell->IsEmpty()) {
-				continue;
+		array<UShort, GRID_WIDTH> empty_cells;
+		array<UShort, GRID_WIDTH> subset_cells;
+		UShort num_empty = 0;
+		UShort num_subset_cells = 0;
+		for (auto cell : cells_) {
+			if (state_.IsEmpty(cell)) {
+				empty_cells[num_empty++] = cell;
+				if (state_.GetMarking(cell).GetCount() <= MAX_SUBSET_SIZE) {
+					subset_cells[num_subset_cells++] = cell;
+				}
 			}
+		}
 
-			// Count the number of occurances of the same set of candidates
-			vector<UShort> target_indices;
-			UShort count = 1;
-			Marking subset = cell->GetMarking();
-			for (UShort j=i+1; j<GRID_WIDTH; j++) {
-				if (cells_[j].lock()->IsEmpty()) {
-					if (subset == cells_[j].lock()->GetMarking()) {
-						count++;
-					} else {
-						target_indices.push_back(j);
-					}
+		for (UShort size=2; size<=MAX_SUBSET_SIZE && size<num_empty; size++) {
+			auto first = tables.first_combination_[size];
+			auto last = first + GetBinomial(num_subset_cells, size);
+			for (auto combination=first; combination<last; combination++) {
+				Marking subset;
+				for (UShort i=0; i<size; i++) {
+					subset.Mark(state_.GetMarking(subset_cells[tables.combinations_[combination][i]]));
 				}
-			}
 
-			if (count > 1 && count == subset.GetCount()) {
-				// Set of candidate occurances match the number of candidates in the set
-				// So, the candiates in the set can be eliminated from other cells in the segment
-				for (auto ti : target_indices) {
-					Marking& marking = cells_[ti].lock()->GetMarking();
-					if (marking.Erase(subset)) {
-						solved = true;
+				// The cells hold only as many candidates as there are cells,
+				// so the candidates can be eliminated from the other cells in the segment
+				if (subset.GetCount() == size) {
+					for (UShort i=0; i<num_empty; i++) {
+						auto cell = empty_cells[i];
+						if (!state_.GetMarking(cell).IsSubsetOf(subset) && state_.EraseCandidates(cell, subset)) {
+							solved = true;
+						}
 					}
 				}
 			}
-
-			if (solved) {
-				break;
-			}
 		}
 
 		return solved;
 	}
 
-	// Solve hidden pairs,triples, quads etc.,
-	bool Segment::SolveHiddenSubsets() {
-		bool solved = false;
+	// Solve hidden pairs, triples and quads, checking every combination of the unsolved numbers
+	// that have at most MAX_SUBSET_SIZE positions in the segment
+	template <class Dimensions>
+	bool BasicSegment<Dimensions>::SolveHiddenSubsets() {
+		using Mask = typename Dimensions::Mask;
+		const auto& tables = SUBSET_TABLES<NUM_BASE>;
+		auto solved = false;
 
-		vector<weak_ptr<Cell>> empty_cells;
-		for (UShort i=0; i<GRID_WIDTH; i++) {
-			auto cell = cells_[i].lock();
-			if (cell->IsEmpty()) {
-				empty_cells.push_back(cell);
+		array<UShort, NUM_BASE> subset_nums;
+		UShort num_unsolved = 0;
+		UShort num_subset_nums = 0;
+		for (auto n : state_.GetUnsolvedNumbers(segment_)) {
+			num_unsolved++;
+			if (Marking::Bits::GetCount(state_.GetPositions(segment_, n)) <= MAX_SUBSET_SIZE) {
+				subset_nums[num_subset_nums++] = n;
 			}
 		}
 
-		Marking subset;
-		UShort least_marking = GRID_WIDTH + 1;
-		for (UShort n=1; n<=NUM_BASE; n++) {
-			UShort marking_count = 0;
-			for (auto cell : empty_cells) {
-				if (cell.lock()->GetMarking().IsMarked(n)) {
-					if (++marking_count > least_marking) {
-						break;
-					}
-				}
-			}
-			if (marking_count != 0) {
-				// The least marked candidates in the segment could probably form a hidden subset
-				if (marking_count == least_marking) {
-					subset.Mark(n);
-				}
-				if (marking_count < least_marking) {
-					least_marking = marking_count;
-					subset.EraseAll();
+		for (UShort size=2; size<=MAX_SUBSET_SIZE && size<num_unsolved; size++) {
+			auto first = tables.first_combination_[size];
+			auto last = first + GetBinomial(num_subset_nums, size);
+			for (auto combination=first; combination<last; combination++) {
+				Marking subset;
+				Mask positions = 0;
+				for (UShort i=0; i<size; i++) {
+					auto n = subset_nums[tables.combinations_[combination][i]];
 					subset.Mark(n);
-				}
-			}
-		}
-
-		// Elimnate the candidates which are already locked pairs, triples etc.,
-		for (auto i=0; i<empty_cells.size()-1; i++) {
-			Marking m1 = empty_cells[i].lock()->GetMarking();
-			UShort count = 1;
-			for (auto j=i+1; j<empty_cells.size(); j++) {
-				Marking m2 = empty_cells[j].lock()->GetMarking();
-				if (m1 == m2) {
-					count++;
-				}
-			}
-			if (count > 1 && count == m1.GetCount()) {
-				subset.Erase(m1);
-			}
-		}
-
-		if (subset.GetCount() != 0) {
-			if (subset.GetCount() > least_marking) {
-				// The least occuring candidates could be distributed across cells and may not form hidden subset
-				// Find out if a set of candidates appear in multiple cells
-				for (auto i=0; i<empty_cells.size()-1; i++) {
-					Marking s1 = subset.MatchSubset(empty_cells[i].lock()->GetMarking());
-					if (s1.GetCount() < 2) {
-						continue;
-					}
-					UShort count = 1;
-					for (auto j=i+1; j<empty_cells.size(); j++) {
-						Marking s2 = subset.MatchSubset(empty_cells[j].lock()->GetMarking());
-						if (s1 == s2) {
-							count++;
-					 	}
-					}
-					if (count > 1 && count == s1.GetCount()) {
-						subset = s1;
-						break;
-					}
-				}
-			}
-
-			if (subset.GetCount() < empty_cells.size()) {
-				vector<UShort> subset_indices;
-				for (UShort i=0; i<GRID_WIDTH; i++) {
-					auto cell = cells_[i].lock();
-					if (cell->IsEmpty()) {
-						if (!subset.MatchSubset(cell->GetMarking()).IsEmpty()) {
-							subset_indices.push_back(i);
-							if (subset_indices.size() > subset.GetCount()) {
-								break;
-							}
-						}
-					}
+					positions |= state_.GetPositions(segment_, n);
 				}
 
-				// If the subset occurs in as many cells as the size of the subset, 
-				// eliminate other candidates in those cells
-				if (subset_indices.size() == subset.GetCount()) {
-					for (auto index : subset_indices) {
-						Marking& marking = cells_[index].lock()->GetMarking();
-						if (marking != subset) {
-							marking.Intersect(subset);
+				// The numbers are left in only as many cells as there are numbers,
+				// so the other candidates can be eliminated from those cells
+				if (Marking::Bits::GetCount(positions) == size) {
+					for (; positions != 0; positions &= positions - 1) {
+						auto position = Marking::Bits::GetLowestNumber(positions) - 1;
+						if (state_.KeepCandidates(cells_[position], subset)) {
 							solved = true;
 						}
 					}
@@ -234,4 +153,9 @@ namespace SudokuAlgorithm {
 
 		return solved;
 	}
+
+    template class BasicSegment<Dimensions6>;
+    template class BasicSegment<Dimensions9>;
+    template class BasicSegment<Dimensions16>;
+    template class BasicSegment<Dimensions25>;
 }
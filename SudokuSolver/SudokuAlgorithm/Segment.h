@@ -21,65 +21,92 @@
 #define Segment_h
 
 #include <array>
-#include <vector>
-#include <memory>
 
 #include "SudokuAlgorithm.h"
-#include "Cell.h"
+#include "GridLayout.h"
+#include "GridState.h"
 
 namespace SudokuAlgorithm {
+    template <class Dimensions> class BasicRow;
+    template <class Dimensions> class BasicColumn;
+    template <class Dimensions> class BasicBlock;
+
 	// Base class for the segment types in the grid - row, column and block
-    class Segment {
+	// A segment refers its cells by index into the grid state
+    template <class Dimensions>
+    class BasicSegment {
     public:
-        Segment(UShort index)  : index_(index), filled_(false) {
+        using GridState = BasicGridState<Dimensions>;
+        using Marking = BasicMarking<Dimensions>;
+
+        static constexpr UShort GRID_WIDTH = Dimensions::GRID_WIDTH;
+        static constexpr UShort NUM_BASE = Dimensions::NUM_BASE;
+
+        BasicSegment(UShort index, UShort segment, GridState& state) :
+            index_(index), segment_(segment), cells_(GRID_LAYOUT<Dimensions>.segment_cells_[segment]), state_(state) {
         }
         
-        Segment() = delete;
-        Segment(const Segment&) = delete;
+        BasicSegment() = delete;
         
-        ~Segment() = default;
+        virtual ~BasicSegment() = default;
         
         UShort GetIndex() const {
             return index_;
         }
         
         bool IsFilled() const {
-            return filled_;
+            return state_.GetUnsolvedNumbers(segment_).IsEmpty();
         }
         
         UShort GetEmptyCellCount() const {
-            return static_cast<UShort>(unsolved_nums_.size());
+            return state_.GetUnsolvedNumbers(segment_).GetCount();
         }
         
 		// Refer the cell in a segment
-		std::weak_ptr<Cell>& operator[] (UShort index);
+		UShort operator[] (UShort index) const;
 	
 		// Count the candidate's marking in a segment
-        UShort GetCandidateCount(UShort num) const;
-		// Update the solved number in the segment and its cell markings
-        void UpdateSolvedNumber(UShort number);
+        UShort GetCandidateCount(UShort num) const {
+            return Marking::Bits::GetCount(state_.GetPositions(segment_, num));
+        }
 		// Find if the number is solved in the given segment
         bool FindNumber(UShort number) const;
 
-		// Solve visible pairs, triples, quads etc.,
+		// Solve visible pairs, triples and quads
         bool SolveVisibleSubsets();
-		// Solve hidden pairs,triples, quads etc.,
+		// Solve hidden pairs, triples and quads
 		bool SolveHiddenSubsets();
 
 		// Intialize is called to prepare the segment for the solution
 		virtual void Initialize();
-		// Solve visible and hidden singles
-		virtual bool SolveSingles() = 0;
 		// Solve intersections or pointing pairs
 		virtual bool SolveIntersections() = 0;
 
     protected:
+		// Index of the row, column and block of a cell in this grid size
+        static UShort GetCellRow(UShort cell) {
+            return SudokuAlgorithm::GetCellRow<Dimensions>(cell);
+        }
+
+        static UShort GetCellColumn(UShort cell) {
+            return SudokuAlgorithm::GetCellColumn<Dimensions>(cell);
+        }
+
+        static UShort GetCellBlock(UShort cell) {
+            return SudokuAlgorithm::GetCellBlock<Dimensions>(cell);
+        }
+
         UShort index_;
-        bool filled_;
+        UShort segment_;
         
-        std::array<std::weak_ptr<Cell>, GRID_WIDTH> cells_;
-        std::vector<UShort> unsolved_nums_;
+        const UShort (&cells_)[GRID_WIDTH];
+        GridState& state_;
     };
+
+    template <class Dimensions> constexpr UShort BasicSegment<Dimensions>::GRID_WIDTH;
+    template <class Dimensions> constexpr UShort BasicSegment<Dimensions>::NUM_BASE;
+
+    using Segment = BasicSegment<Dimensions9>;
 }
 
 #endif /* Segment_h */
@@ -0,0 +1,264 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  SinglesKernel.cpp
+//  SudokuAlgorithm
+//
+
+#include <atomic>
+#include <cstring>
+
+#include "SinglesKernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SINGLES_KERNEL_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+    namespace {
+        using FindSinglesFunction = void (*)(const GridState& state, SinglesMasks<Dimensions9>& masks);
+
+        template <class Dimensions>
+        void FindSinglesScalar(const BasicGridState<Dimensions>& state, SinglesMasks<Dimensions>& masks) {
+            const auto& markings = state.GetMarkings();
+
+            for (UShort cell=0; cell<Dimensions::NUM_GRID_CELLS; cell++) {
+                auto candidates = markings[cell].GetNumbers();
+                masks.naked_[cell] = (candidates & (candidates - 1)) == 0 ? candidates : 0;
+            }
+
+            for (UShort segment=0; segment<Dimensions::NUM_SEGMENTS; segment++) {
+                typename Dimensions::Mask once = 0;
+                typename Dimensions::Mask twice = 0;
+                for (auto cell : GRID_LAYOUT<Dimensions>.segment_cells_[segment]) {
+                    auto candidates = markings[cell].GetNumbers();
+                    twice |= once & candidates;
+                    once |= candidates;
+                }
+
+                masks.seen_once_[segment] = once;
+                masks.seen_twice_[segment] = twice;
+            }
+        }
+
+#ifdef SINGLES_KERNEL_AVX2
+		// The AVX2 kernel is written for the 9x9 grid
+        constexpr UShort GRID_WIDTH = Dimensions9::GRID_WIDTH;
+        constexpr UShort BLOCK_WIDTH = Dimensions9::BOX_COLUMNS;
+        constexpr UShort NUM_GRID_CELLS = Dimensions9::NUM_GRID_CELLS;
+        constexpr UShort FIRST_ROW = Dimensions9::FIRST_ROW;
+        constexpr UShort FIRST_COLUMN = Dimensions9::FIRST_COLUMN;
+        constexpr UShort FIRST_BLOCK = Dimensions9::FIRST_BLOCK;
+
+        static_assert(Dimensions9::BOX_ROWS == BLOCK_WIDTH, "the blocks of the 9x9 grid are square");
+
+        constexpr UShort VECTOR_LANES = 16;
+		// Vectors covering the cells of the grid
+        constexpr UShort NUM_VECTORS = (NUM_GRID_CELLS + VECTOR_LANES - 1)/VECTOR_LANES;
+		// Lanes of the padded buffers; loads run up to two rows past the last vector
+        constexpr UShort PADDED_LANES = 128;
+
+        static_assert((NUM_VECTORS - 1)*VECTOR_LANES + 2*GRID_WIDTH + VECTOR_LANES <= PADDED_LANES, "padded buffers hold the shifted loads");
+
+        TARGET_AVX2 inline __m256i Load(const UShort* lanes) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+        }
+
+        TARGET_AVX2 inline void Store(UShort* lanes, __m256i v) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+        }
+
+		// Combine the seen once, seen twice masks of three groups of cells
+        TARGET_AVX2 inline void Combine(__m256i once0, __m256i twice0, __m256i once1, __m256i twice1,
+                                        __m256i once2, __m256i twice2, __m256i& once, __m256i& twice) {
+            auto once01 = _mm256_or_si256(once0, once1);
+            auto twice01 = _mm256_or_si256(_mm256_or_si256(twice0, twice1), _mm256_and_si256(once0, once1));
+            once = _mm256_or_si256(once01, once2);
+            twice = _mm256_or_si256(_mm256_or_si256(twice01, twice2), _mm256_and_si256(once01, once2));
+        }
+
+		// Combine the masks of the lanes offset, 2*offset apart, into the first lane
+        TARGET_AVX2 inline void CombineLanes(const UShort* once, const UShort* twice, UShort offset,
+                                             UShort* combined_once, UShort* combined_twice) {
+            for (UShort v=0; v<NUM_VECTORS; v++) {
+                auto lane = v*VECTOR_LANES;
+                __m256i o, t;
+                Combine(Load(once + lane), Load(twice + lane),
+                        Load(once + lane + offset), Load(twice + lane + offset),
+                        Load(once + lane + 2*offset), Load(twice + lane + 2*offset), o, t);
+                Store(combined_once + lane, o);
+                Store(combined_twice + lane, t);
+            }
+        }
+
+		// The grid is processed as 16 bit lanes in row major order. Shifted loads of the cells
+		// combine each cell with its two right neighbours into triples; three triples make a row
+		// in the first lane of the row, and three triples one row apart make a block.
+		// The columns add up the nine rows loaded one row apart
+        TARGET_AVX2 void FindSinglesAvx2(const GridState& state, SinglesMasks<Dimensions9>& masks) {
+            alignas(32) UShort cells[PADDED_LANES] = {};
+            alignas(32) UShort naked[PADDED_LANES];
+            alignas(32) UShort triple_once[PADDED_LANES] = {};
+            alignas(32) UShort triple_twice[PADDED_LANES] = {};
+            alignas(32) UShort once[PADDED_LANES];
+            alignas(32) UShort twice[PADDED_LANES];
+
+            static_assert(sizeof(Marking) == sizeof(UShort), "markings are copied as candidate masks");
+            memcpy(cells, state.GetMarkings().data(), NUM_GRID_CELLS*sizeof(UShort));
+
+            const auto zero = _mm256_setzero_si256();
+            const auto one = _mm256_set1_epi16(1);
+            for (UShort v=0; v<NUM_VECTORS; v++) {
+                auto lane = v*VECTOR_LANES;
+                auto candidates = Load(cells + lane);
+
+				// A single candidate has no other bit than its lowest
+                auto single = _mm256_cmpeq_epi16(_mm256_and_si256(candidates, _mm256_sub_epi16(candidates, one)), zero);
+                Store(naked + lane, _mm256_and_si256(candidates, single));
+
+                auto left = candidates;
+                auto middle = Load(cells + lane + 1);
+                auto right = Load(cells + lane + 2);
+                Store(triple_once + lane, _mm256_or_si256(_mm256_or_si256(left, middle), right));
+                Store(triple_twice + lane, _mm256_or_si256(_mm256_and_si256(left, middle),
+                                                           _mm256_and_si256(right, _mm256_or_si256(left, middle))));
+            }
+            memcpy(masks.naked_, naked, NUM_GRID_CELLS*sizeof(UShort));
+
+			// Rows, in the lane of the first cell of each row
+            CombineLanes(triple_once, triple_twice, BLOCK_WIDTH, once, twice);
+            for (UShort row=0; row<GRID_WIDTH; row++) {
+                masks.seen_once_[FIRST_ROW + row] = once[row*GRID_WIDTH];
+                masks.seen_twice_[FIRST_ROW + row] = twice[row*GRID_WIDTH];
+            }
+
+			// Blocks, in the lane of the first cell of each block
+            CombineLanes(triple_once, triple_twice, GRID_WIDTH, once, twice);
+            for (UShort block=0; block<GRID_WIDTH; block++) {
+                auto lane = (block/BLOCK_WIDTH)*BLOCK_WIDTH*GRID_WIDTH + (block%BLOCK_WIDTH)*BLOCK_WIDTH;
+                masks.seen_once_[FIRST_BLOCK + block] = once[lane];
+                masks.seen_twice_[FIRST_BLOCK + block] = twice[lane];
+            }
+
+			// Columns, in the first row
+            auto column_once = zero;
+            auto column_twice = zero;
+            for (UShort row=0; row<GRID_WIDTH; row++) {
+                auto candidates = Load(cells + row*GRID_WIDTH);
+                column_twice = _mm256_or_si256(column_twice, _mm256_and_si256(column_once, candidates));
+                column_once = _mm256_or_si256(column_once, candidates);
+            }
+            Store(once, column_once);
+            Store(twice, column_twice);
+            for (UShort column=0; column<GRID_WIDTH; column++) {
+                masks.seen_once_[FIRST_COLUMN + column] = once[column];
+                masks.seen_twice_[FIRST_COLUMN + column] = twice[column];
+            }
+        }
+
+        bool CpuSupportsAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+
+			// The OS saves the AVX registers, and the processor has AVX2
+            __cpuid(info, 1);
+            if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) {
+                return false;
+            }
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return false;
+#endif
+        }
+#else
+        bool CpuSupportsAvx2() {
+            return false;
+        }
+#endif
+
+        FindSinglesFunction GetKernelFunction(SinglesKernel kernel) {
+#ifdef SINGLES_KERNEL_AVX2
+            if (kernel == SinglesKernel::Avx2) {
+                return FindSinglesAvx2;
+            }
+#endif
+            return FindSinglesScalar<Dimensions9>;
+        }
+
+        atomic<FindSinglesFunction>& SelectedKernel() {
+            static atomic<FindSinglesFunction> selected(
+                GetKernelFunction(IsAvx2Supported() ? SinglesKernel::Avx2 : SinglesKernel::Scalar));
+            return selected;
+        }
+    }
+
+	// Compute the naked singles and the seen once, seen twice masks of the grid with the selected kernel
+    template <class Dimensions>
+    void FindSingles(const BasicGridState<Dimensions>& state, SinglesMasks<Dimensions>& masks) {
+        FindSinglesScalar(state, masks);
+    }
+
+    template <>
+    void FindSingles<Dimensions9>(const BasicGridState<Dimensions9>& state, SinglesMasks<Dimensions9>& masks) {
+        SelectedKernel().load(memory_order_relaxed)(state, masks);
+    }
+
+    template void FindSingles<Dimensions6>(const BasicGridState<Dimensions6>& state, SinglesMasks<Dimensions6>& masks);
+    template void FindSingles<Dimensions16>(const BasicGridState<Dimensions16>& state, SinglesMasks<Dimensions16>& masks);
+    template void FindSingles<Dimensions25>(const BasicGridState<Dimensions25>& state, SinglesMasks<Dimensions25>& masks);
+
+	// True if the processor and the compiler support the AVX2 kernel
+    bool IsAvx2Supported() {
+        static const bool supported = CpuSupportsAvx2();
+        return supported;
+    }
+
+	// Kernel used by FindSingles, AVX2 when it is supported, otherwise scalar
+    SinglesKernel GetSinglesKernel() {
+        return SelectedKernel().load() == FindSinglesScalar<Dimensions9> ? SinglesKernel::Scalar : SinglesKernel::Avx2;
+    }
+
+	// Select the kernel, false if it is not supported
+    bool SelectSinglesKernel(SinglesKernel kernel) {
+        if (kernel == SinglesKernel::Avx2 && !IsAvx2Supported()) {
+            return false;
+        }
+
+        SelectedKernel().store(GetKernelFunction(kernel));
+        return true;
+    }
+}
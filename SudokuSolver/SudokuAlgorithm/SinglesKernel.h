@@ -0,0 +1,66 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  SinglesKernel.h
+//  SudokuAlgorithm
+//
+
+#ifndef SinglesKernel_h
+#define SinglesKernel_h
+
+#include "SudokuAlgorithm.h"
+#include "GridLayout.h"
+#include "GridState.h"
+
+namespace SudokuAlgorithm {
+	// Candidate masks of all the cells and segments, computed in one pass over the grid
+    template <class Dimensions>
+    struct SinglesMasks final {
+        using Mask = typename Dimensions::Mask;
+
+		// The candidate of each cell with a single candidate, 0 otherwise
+        Mask naked_[Dimensions::NUM_GRID_CELLS];
+		// Candidates marked in at least one cell of each segment
+        Mask seen_once_[Dimensions::NUM_SEGMENTS];
+		// Candidates marked in at least two cells of each segment
+        Mask seen_twice_[Dimensions::NUM_SEGMENTS];
+    };
+
+	// Implementations of the singles kernel
+    enum class SinglesKernel {
+        Scalar,
+        Avx2
+    };
+
+	// Compute the naked singles and the seen once, seen twice masks of the grid with the selected kernel.
+	// A hidden single of a segment is seen once but not twice; the segment is covered
+	// when each of its unsolved numbers is seen once. Only the 9x9 grid has the AVX2 kernel
+    template <class Dimensions>
+    void FindSingles(const BasicGridState<Dimensions>& state, SinglesMasks<Dimensions>& masks);
+
+    template <>
+    void FindSingles<Dimensions9>(const BasicGridState<Dimensions9>& state, SinglesMasks<Dimensions9>& masks);
+
+	// True if the processor and the compiler support the AVX2 kernel
+    bool IsAvx2Supported();
+
+	// Kernel used by FindSingles, AVX2 when it is supported, otherwise scalar
+    SinglesKernel GetSinglesKernel();
+	// Select the kernel, false if it is not supported. Select before solving, for all the threads
+    bool SelectSinglesKernel(SinglesKernel kernel);
+}
+
+#endif /* SinglesKernel_h */
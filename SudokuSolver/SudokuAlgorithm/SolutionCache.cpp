@@ -0,0 +1,130 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  SolutionCache.cpp
+//  SudokuAlgorithm
+//
+
+#include <algorithm>
+
+#include "SolutionCache.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Allocate the table, as many entries as fit the memory
+    template <class Dimensions>
+    BasicSolutionCache<Dimensions>::BasicSolutionCache(size_t max_memory)
+        : num_buckets_(max<size_t>(1, max_memory/(BUCKET_ENTRIES*sizeof(Entry)))),
+          clock_(0), lookups_(0), hits_(0), skipped_(0), insertions_(0), evictions_(0), used_entries_(0) {
+        entries_.resize(num_buckets_*BUCKET_ENTRIES, Entry{});
+    }
+
+	// Find the solution of the puzzle of the canonical form, mapped back to the puzzle, false if it is not held
+    template <class Dimensions>
+    bool BasicSolutionCache<Dimensions>::Find(const CanonicalForm& form, Puzzle& solution) {
+        lookups_++;
+
+        array<unsigned char, PackedFormat::PUZZLE_SIZE> puzzle;
+        auto hash = PackPuzzle(form.GetPuzzle(), puzzle);
+        auto bucket = hash % num_buckets_;
+
+        Puzzle canonical_solution;
+        {
+            lock_guard<mutex> lock(locks_[bucket % NUM_LOCKS]);
+            auto first = entries_.begin() + bucket*BUCKET_ENTRIES;
+            auto entry = find_if(first, first + BUCKET_ENTRIES, [&](const Entry& e) {
+                return e.hash == hash && e.puzzle == puzzle;
+            });
+            if (entry == first + BUCKET_ENTRIES) {
+                return false;
+            }
+
+            entry->last_used = ++clock_;
+            PackedFormat::UnpackSolution(entry->solution.data(), canonical_solution);
+        }
+
+        form.FromCanonical(canonical_solution, solution);
+        hits_++;
+        return true;
+    }
+
+	// Hold the solution of the puzzle of the canonical form, in place of the least recently used entry
+	// of its bucket when the bucket is full
+    template <class Dimensions>
+    void BasicSolutionCache<Dimensions>::Insert(const CanonicalForm& form, const Puzzle& solution) {
+        Puzzle canonical_solution;
+        form.ToCanonical(solution, canonical_solution);
+
+        Entry new_entry;
+        new_entry.hash = PackPuzzle(form.GetPuzzle(), new_entry.puzzle);
+        if (!PackedFormat::PackSolution(canonical_solution, new_entry.solution.data())) {
+            return;
+        }
+
+        auto bucket = new_entry.hash % num_buckets_;
+        lock_guard<mutex> lock(locks_[bucket % NUM_LOCKS]);
+        auto first = entries_.begin() + bucket*BUCKET_ENTRIES;
+        auto entry = first;
+        for (auto e = first; e != first + BUCKET_ENTRIES; ++e) {
+            if (e->hash == new_entry.hash && e->puzzle == new_entry.puzzle) {
+                return;
+            }
+            if (e->last_used < entry->last_used) {
+                entry = e;
+            }
+        }
+
+        if (entry->hash != 0) {
+            evictions_++;
+        } else {
+            used_entries_++;
+        }
+        new_entry.last_used = ++clock_;
+        *entry = new_entry;
+        insertions_++;
+    }
+
+    template <class Dimensions>
+    SolutionCacheStats BasicSolutionCache<Dimensions>::GetStats() const {
+        SolutionCacheStats stats;
+        stats.lookups = lookups_;
+        stats.hits = hits_;
+        stats.skipped = skipped_;
+        stats.insertions = insertions_;
+        stats.evictions = evictions_;
+        stats.entries = used_entries_;
+        stats.capacity = entries_.size();
+        stats.memory_bytes = entries_.size()*sizeof(Entry);
+        return stats;
+    }
+
+	// Pack the canonical puzzle and hash it, FNV-1a of the packed bytes. The hash of an empty entry is 0
+    template <class Dimensions>
+    uint64_t BasicSolutionCache<Dimensions>::PackPuzzle(const Puzzle& puzzle, array<unsigned char, PackedFormat::PUZZLE_SIZE>& packed) {
+        PackedFormat::PackPuzzle(puzzle, packed.data());
+
+        uint64_t hash = 0xcbf29ce484222325;
+        for (auto byte : packed) {
+            hash = (hash ^ byte)*0x100000001b3;
+        }
+        return hash != 0 ? hash : 1;
+    }
+
+    template class BasicSolutionCache<Dimensions6>;
+    template class BasicSolutionCache<Dimensions9>;
+    template class BasicSolutionCache<Dimensions16>;
+    template class BasicSolutionCache<Dimensions25>;
+}
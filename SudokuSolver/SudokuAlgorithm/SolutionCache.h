@@ -0,0 +1,120 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+//  SolutionCache.h
+//  SudokuAlgorithm
+//
+
+#ifndef SolutionCache_h
+#define SolutionCache_h
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "SudokuAlgorithm.h"
+#include "Puzzle.h"
+#include "CanonicalForm.h"
+#include "PackedPuzzles.h"
+
+namespace SudokuAlgorithm {
+	// Counters of a solution cache
+    struct SolutionCacheStats {
+		// Puzzles looked up, and found
+        unsigned long long lookups;
+        unsigned long long hits;
+		// Puzzles with too many tied keys for a canonical form, solved without the cache
+        unsigned long long skipped;
+        unsigned long long insertions;
+        unsigned long long evictions;
+		// Solutions held, out of the capacity
+        std::size_t entries;
+        std::size_t capacity;
+		// Bytes of the table of the entries, allocated up front
+        std::size_t memory_bytes;
+
+        double GetHitRatio() const {
+            return lookups > 0 ? static_cast<double>(hits)/lookups : 0;
+        }
+    };
+
+	// Solutions of the puzzles solved so far, by the canonical form of the puzzle, so a puzzle equivalent
+	// to one solved before is answered without solving it. The entries hold the canonical puzzle and its
+	// solution packed, and live in a table of fixed size; the least recently used entry of a bucket
+	// makes room for a new one. Threads may share the cache, the buckets are locked in stripes
+    template <class Dimensions>
+    class BasicSolutionCache final {
+    public:
+        using Puzzle = BasicPuzzle<Dimensions>;
+        using CanonicalForm = BasicCanonicalForm<Dimensions>;
+        using PackedFormat = BasicPackedFormat<Dimensions>;
+
+		// Entries of a bucket, and locks for the buckets
+        static constexpr std::size_t BUCKET_ENTRIES = 4;
+        static constexpr std::size_t NUM_LOCKS = 64;
+        static constexpr std::size_t DEFAULT_MEMORY = std::size_t(64) << 20;
+
+		// Allocate the table, as many entries as fit the memory
+        explicit BasicSolutionCache(std::size_t max_memory = DEFAULT_MEMORY);
+        BasicSolutionCache(const BasicSolutionCache&) = delete;
+        BasicSolutionCache& operator= (const BasicSolutionCache&) = delete;
+
+		// Find the solution of the puzzle of the canonical form, mapped back to the puzzle, false if it is not held
+        bool Find(const CanonicalForm& form, Puzzle& solution);
+		// Hold the solution of the puzzle of the canonical form
+        void Insert(const CanonicalForm& form, const Puzzle& solution);
+		// Count a puzzle solved without the cache, as it has no canonical form
+        void Skip() {
+            skipped_++;
+        }
+
+        SolutionCacheStats GetStats() const;
+
+    private:
+        struct Entry {
+			// Hash of the packed puzzle, 0 for an empty entry
+            std::uint64_t hash;
+			// Access of the entry, the lowest in the bucket is evicted first
+            std::uint64_t last_used;
+            std::array<unsigned char, PackedFormat::PUZZLE_SIZE> puzzle;
+            std::array<unsigned char, PackedFormat::SOLUTION_SIZE> solution;
+        };
+
+		// Pack the canonical puzzle and hash it
+        static std::uint64_t PackPuzzle(const Puzzle& puzzle, std::array<unsigned char, PackedFormat::PUZZLE_SIZE>& packed);
+
+        std::vector<Entry> entries_;
+        std::size_t num_buckets_;
+        std::array<std::mutex, NUM_LOCKS> locks_;
+        std::atomic<std::uint64_t> clock_;
+        std::atomic<unsigned long long> lookups_;
+        std::atomic<unsigned long long> hits_;
+        std::atomic<unsigned long long> skipped_;
+        std::atomic<unsigned long long> insertions_;
+        std::atomic<unsigned long long> evictions_;
+        std::atomic<std::size_t> used_entries_;
+    };
+
+    template <class Dimensions> constexpr std::size_t BasicSolutionCache<Dimensions>::BUCKET_ENTRIES;
+    template <class Dimensions> constexpr std::size_t BasicSolutionCache<Dimensions>::NUM_LOCKS;
+    template <class Dimensions> constexpr std::size_t BasicSolutionCache<Dimensions>::DEFAULT_MEMORY;
+
+    using SolutionCache = BasicSolutionCache<Dimensions9>;
+}
+
+#endif /* SolutionCache_h */
@@ -0,0 +1,87 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  SubsetTables.h
+//  SudokuAlgorithm
+//
+
+#ifndef SubsetTables_h
+#define SubsetTables_h
+
+#include <cstdint>
+
+#include "SudokuAlgorithm.h"
+
+namespace SudokuAlgorithm {
+	// Largest subset searched, a quad
+    constexpr UShort MAX_SUBSET_SIZE = 4;
+
+    constexpr std::uint32_t GetBinomial(UShort n, UShort k) {
+        return k > n ? 0 : (k == 0 ? 1 : GetBinomial(n - 1, k - 1) * n / k);
+    }
+
+	// Combinations of 2 to MAX_SUBSET_SIZE indices out of NumItems, for the subsets of the segments.
+	// The combinations of each size are in colexicographic order, so the combinations of the first
+	// n indices are the first GetBinomial(n, size) of them
+    template <UShort NumItems>
+    struct SubsetTables final {
+        static constexpr std::uint32_t NUM_COMBINATIONS =
+            GetBinomial(NumItems, 2) + GetBinomial(NumItems, 3) + GetBinomial(NumItems, 4);
+
+		// Index of the first combination of each size
+        std::uint32_t first_combination_[MAX_SUBSET_SIZE + 1];
+		// Indices of each combination, in increasing order
+        std::uint8_t combinations_[NUM_COMBINATIONS][MAX_SUBSET_SIZE];
+    };
+
+    template <UShort NumItems>
+    constexpr SubsetTables<NumItems> MakeSubsetTables() {
+        SubsetTables<NumItems> tables{};
+
+		// The largest index varies slowest, which gives the colexicographic order
+        std::uint32_t combination = 0;
+        for (UShort size=2; size<=MAX_SUBSET_SIZE; size++) {
+            tables.first_combination_[size] = combination;
+
+            UShort indices[MAX_SUBSET_SIZE] = {};
+            for (UShort i=0; i<size; i++) {
+                indices[i] = i;
+            }
+
+            while (indices[size - 1] < NumItems) {
+                for (UShort i=0; i<size; i++) {
+                    tables.combinations_[combination][i] = static_cast<std::uint8_t>(indices[i]);
+                }
+                combination++;
+
+				// Advance the lowest index that can move up, and reset the indices below it
+                UShort i = 0;
+                while (i + 1 < size && indices[i] + 1 == indices[i + 1]) {
+                    indices[i] = i;
+                    i++;
+                }
+                indices[i]++;
+            }
+        }
+
+        return tables;
+    }
+
+    template <UShort NumItems>
+    constexpr SubsetTables<NumItems> SUBSET_TABLES = MakeSubsetTables<NumItems>();
+}
+
+#endif /* SubsetTables_h */
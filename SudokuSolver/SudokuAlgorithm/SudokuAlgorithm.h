@@ -20,11 +20,64 @@
 #ifndef SudokuAlgorithm_h
 #define SudokuAlgorithm_h
 
+#include <cstdint>
+#include <type_traits>
+
 typedef unsigned short UShort;
 
-constexpr UShort NUM_BASE = 9;
-constexpr UShort GRID_WIDTH = 9;
-constexpr UShort BLOCK_WIDTH = 3;
-constexpr UShort NUM_GRID_CELLS = (GRID_WIDTH*GRID_WIDTH);
+namespace SudokuAlgorithm {
+	// Size of a grid with blocks of BoxRows rows and BoxColumns columns. The grid has
+	// as many rows, columns, blocks and numbers as there are cells in a block
+    template <UShort BoxRows, UShort BoxColumns>
+    struct GridDimensions final {
+        static constexpr UShort BOX_ROWS = BoxRows;
+        static constexpr UShort BOX_COLUMNS = BoxColumns;
+        static constexpr UShort GRID_WIDTH = BoxRows*BoxColumns;
+        static constexpr UShort NUM_BASE = GRID_WIDTH;
+        static constexpr UShort NUM_GRID_CELLS = GRID_WIDTH*GRID_WIDTH;
+
+		// Segments are numbered rows first, then columns, then blocks
+        static constexpr UShort FIRST_ROW = 0;
+        static constexpr UShort FIRST_COLUMN = GRID_WIDTH;
+        static constexpr UShort FIRST_BLOCK = 2*GRID_WIDTH;
+        static constexpr UShort NUM_SEGMENTS = 3*GRID_WIDTH;
+        static constexpr UShort SEGMENTS_PER_CELL = 3;
+
+		// Candidates of a cell, one bit for each number
+        using Mask = typename std::conditional<(NUM_BASE <= 16), std::uint16_t, std::uint32_t>::type;
+
+        static_assert(BoxRows > 1 && BoxColumns > 1 && NUM_BASE <= 32, "the numbers of a grid fit a 32 bit mask");
+    };
+
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::BOX_ROWS;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::BOX_COLUMNS;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::GRID_WIDTH;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::NUM_BASE;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::NUM_GRID_CELLS;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::FIRST_ROW;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::FIRST_COLUMN;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::FIRST_BLOCK;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::NUM_SEGMENTS;
+    template <UShort BoxRows, UShort BoxColumns> constexpr UShort GridDimensions<BoxRows, BoxColumns>::SEGMENTS_PER_CELL;
+
+	// Character of a number in puzzle files and displays - digits up to 9, then letters from 'A' for 10
+    constexpr char GetNumberChar(UShort num) {
+        return num < 10 ? static_cast<char>('0' + num) : static_cast<char>('A' + num - 10);
+    }
+
+	// Number of a character in puzzle files, 0 for an empty cell or a character which is not a number.
+	// 'X' marks an empty cell
+    constexpr UShort GetCharNumber(char c) {
+        return (c >= '1' && c <= '9') ? c - '0' :
+               (c >= 'A' && c <= 'W') ? c - 'A' + 10 :
+               (c >= 'a' && c <= 'w') ? c - 'a' + 10 : 0;
+    }
+
+	// Grid sizes instantiated by the library - 6x6 with 2x3 blocks, 9x9, 16x16 and 25x25
+    using Dimensions6 = GridDimensions<2, 3>;
+    using Dimensions9 = GridDimensions<3, 3>;
+    using Dimensions16 = GridDimensions<4, 4>;
+    using Dimensions25 = GridDimensions<5, 5>;
+}
 
 #endif /* SudokuAlgorithm_h */
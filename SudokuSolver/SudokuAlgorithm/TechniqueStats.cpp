@@ -0,0 +1,88 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  TechniqueStats.cpp
+//  SudokuAlgorithm
+//
+
+#include "TechniqueStats.h"
+
+using namespace std;
+
+namespace SudokuAlgorithm {
+	// Name of the technique in the exported statistics
+    const char* GetTechniqueName(Technique technique) {
+        switch (technique) {
+            case Technique::Singles:
+                return "singles";
+            case Technique::Intersections:
+                return "intersections";
+            case Technique::VisibleSubsets:
+                return "visible_subsets";
+            case Technique::HiddenSubsets:
+                return "hidden_subsets";
+            case Technique::Fish:
+                return "fish";
+            case Technique::XYWing:
+                return "xy_wing";
+            case Technique::XYZWing:
+                return "xyz_wing";
+            case Technique::SimpleColoring:
+                return "simple_coloring";
+        }
+
+        return "unknown";
+    }
+
+	// True if the library was built to record the statistics. Defined here rather than in the header,
+	// so a driver built without SUDOKU_TECHNIQUE_STATS still reports what the library records
+    bool TechniqueStats::IsEnabled() {
+#ifdef SUDOKU_TECHNIQUE_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+	// Add the counters of other statistics, to total the solvers of several threads
+    TechniqueStats& TechniqueStats::operator+= (const TechniqueStats& stats) {
+        for (size_t i = 0; i < NUM_TECHNIQUES; i++) {
+            counters_[i].calls += stats.counters_[i].calls;
+            counters_[i].productive_calls += stats.counters_[i].productive_calls;
+            counters_[i].eliminations += stats.counters_[i].eliminations;
+            counters_[i].placements += stats.counters_[i].placements;
+            counters_[i].nanoseconds += stats.counters_[i].nanoseconds;
+        }
+
+        return *this;
+    }
+
+	// Write the counters as a JSON object, keyed by the technique name
+    void TechniqueStats::WriteJson(ostream& out) const {
+        out << "{\n  \"enabled\": " << (IsEnabled() ? "true" : "false") << ",\n  \"techniques\": {";
+        for (size_t i = 0; i < NUM_TECHNIQUES; i++) {
+            const auto& counters = counters_[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "    \"" << GetTechniqueName(static_cast<Technique>(i)) << "\": {"
+                << "\"calls\": " << counters.calls
+                << ", \"productive_calls\": " << counters.productive_calls
+                << ", \"eliminations\": " << counters.eliminations
+                << ", \"placements\": " << counters.placements
+                << ", \"nanoseconds\": " << counters.nanoseconds << "}";
+        }
+        out << "\n  }\n}\n";
+    }
+}
@@ -0,0 +1,138 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+//
+//  TechniqueStats.h
+//  SudokuAlgorithm
+//
+
+#ifndef TechniqueStats_h
+#define TechniqueStats_h
+
+#include <array>
+#include <ostream>
+#include <cstddef>
+
+#ifdef SUDOKU_TECHNIQUE_STATS
+#include <chrono>
+#endif
+
+#include "SudokuAlgorithm.h"
+
+namespace SudokuAlgorithm {
+	// Solving techniques measured by the statistics
+    enum class Technique {
+        Singles,
+        Intersections,
+        VisibleSubsets,
+        HiddenSubsets,
+        Fish,
+        XYWing,
+        XYZWing,
+        SimpleColoring
+    };
+
+    constexpr std::size_t NUM_TECHNIQUES = 8;
+
+	// Name of the technique in the exported statistics
+    const char* GetTechniqueName(Technique technique);
+
+	// Counters of one technique. Eliminations count every candidate erased, including
+	// the candidates of the cells and peers that a placement solves
+    struct TechniqueCounters {
+        unsigned long long calls;
+        unsigned long long productive_calls;
+        unsigned long long eliminations;
+        unsigned long long placements;
+        unsigned long long nanoseconds;
+    };
+
+	// Counters of all the techniques, recorded only when SUDOKU_TECHNIQUE_STATS is defined
+    class TechniqueStats final {
+    public:
+        TechniqueStats() : counters_{} {
+        }
+
+		// True if the library was built to record the statistics, whatever the caller was built with
+        static bool IsEnabled();
+
+        const TechniqueCounters& GetCounters(Technique technique) const {
+            return counters_[static_cast<std::size_t>(technique)];
+        }
+
+        void Record(Technique technique, unsigned long eliminations, unsigned long placements, unsigned long long nanoseconds) {
+            auto& counters = counters_[static_cast<std::size_t>(technique)];
+            counters.calls++;
+            if (eliminations > 0 || placements > 0) {
+                counters.productive_calls++;
+            }
+            counters.eliminations += eliminations;
+            counters.placements += placements;
+            counters.nanoseconds += nanoseconds;
+        }
+
+		// Add the counters of other statistics, to total the solvers of several threads
+        TechniqueStats& operator+= (const TechniqueStats& stats);
+
+        void Reset() {
+            counters_ = {};
+        }
+
+		// Write the counters as a JSON object, keyed by the technique name
+        void WriteJson(std::ostream& out) const;
+
+    private:
+        std::array<TechniqueCounters, NUM_TECHNIQUES> counters_;
+    };
+
+	// Records one call of a technique on the grid state, from its construction to its destruction.
+	// Compiles to nothing when SUDOKU_TECHNIQUE_STATS is not defined
+    template <class GridState>
+    class TechniqueScope final {
+    public:
+#ifdef SUDOKU_TECHNIQUE_STATS
+        TechniqueScope(TechniqueStats& stats, Technique technique, const GridState& state) :
+            stats_(stats), technique_(technique), state_(state),
+            candidates_(state.GetCandidateCount()), filled_cells_(state.GetFilledCount()),
+            start_(std::chrono::steady_clock::now()) {
+        }
+
+        ~TechniqueScope() {
+            auto end = std::chrono::steady_clock::now();
+            auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count();
+            stats_.Record(technique_, candidates_ - state_.GetCandidateCount(),
+                          state_.GetFilledCount() - filled_cells_, static_cast<unsigned long long>(nanoseconds));
+        }
+#else
+        TechniqueScope(TechniqueStats&, Technique, const GridState&) {
+        }
+#endif
+
+        TechniqueScope(const TechniqueScope&) = delete;
+        TechniqueScope& operator= (const TechniqueScope&) = delete;
+
+#ifdef SUDOKU_TECHNIQUE_STATS
+    private:
+        TechniqueStats& stats_;
+        Technique technique_;
+        const GridState& state_;
+        unsigned long candidates_;
+        unsigned long filled_cells_;
+        std::chrono::steady_clock::time_point start_;
+#endif
+    };
+}
+
+#endif /* TechniqueStats_h */
@@ -0,0 +1,352 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+// SudokuBench.cpp
+// SudokuBench
+//
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+#include "BatchSolver.h"
+#include "PuzzleReader.h"
+#include "PackedPuzzles.h"
+#include "SinglesKernel.h"
+
+using namespace std;
+
+using namespace SudokuAlgorithm;
+
+// Heap allocations of the process, counted by the replaced operator new
+atomic<unsigned long> allocation_count(0);
+
+template <class Dimensions>
+int RunBench(const string& path, Engine engine, unsigned num_threads, int warmup_runs, int measured_runs,
+             const string& stats_path, bool check_allocations, bool count_solutions, size_t cache_megabytes);
+template <class Dimensions>
+void LoadPuzzles(const string& path, vector<BasicPuzzle<Dimensions>>& puzzles);
+double Percentile(const vector<double>& sorted_latencies, double percent);
+void WriteStats(const string& path, const TechniqueStats& stats);
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: sudoku_bench <puzzle file> [--warmup N] [--runs N] [--engine logic|search|dlx] [--threads N] [--kernel scalar|avx2] [--size 6|9|16|25] [--stats <json file>] [--check-allocations] [--count] [--cache <MB>]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    string path = argv[1];
+    int warmup_runs = 1;
+    int measured_runs = 5;
+    Engine engine = Engine::Search;
+    unsigned num_threads = 0;
+    int size = 9;
+    string stats_path;
+    bool check_allocations = false;
+    bool count_solutions = false;
+    size_t cache_megabytes = 0;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--warmup" && i + 1 < argc) {
+            warmup_runs = atoi(argv[++i]);
+        } else if (arg == "--runs" && i + 1 < argc) {
+            measured_runs = max(1, atoi(argv[++i]));
+        } else if (arg == "--engine" && i + 1 < argc) {
+            string engine_str = argv[++i];
+            if (engine_str == "logic") {
+                engine = Engine::Logic;
+            } else if (engine_str == "search") {
+                engine = Engine::Search;
+            } else if (engine_str == "dlx") {
+                engine = Engine::DancingLinks;
+            } else {
+                cout << "Unknown engine: " << engine_str << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--kernel" && i + 1 < argc) {
+            string kernel_str = argv[++i];
+            if (kernel_str != "scalar" && kernel_str != "avx2") {
+                cout << "Unknown kernel: " << kernel_str << endl;
+                return EXIT_FAILURE;
+            }
+            if (!SelectSinglesKernel(kernel_str == "avx2" ? SinglesKernel::Avx2 : SinglesKernel::Scalar)) {
+                cout << "The " << kernel_str << " kernel is not supported" << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--size" && i + 1 < argc) {
+            size = atoi(argv[++i]);
+            if (size != 6 && size != 9 && size != 16 && size != 25) {
+                cout << "Unsupported size: " << argv[i] << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--stats" && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else if (arg == "--check-allocations") {
+            check_allocations = true;
+        } else if (arg == "--count") {
+            count_solutions = true;
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cache_megabytes = max(1, atoi(argv[++i]));
+        } else {
+            cout << "Unknown option: " << arg << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    switch (size) {
+    case 6:
+        return RunBench<Dimensions6>(path, engine, num_threads, warmup_runs, measured_runs, stats_path, check_allocations, count_solutions, cache_megabytes);
+    case 16:
+        return RunBench<Dimensions16>(path, engine, num_threads, warmup_runs, measured_runs, stats_path, check_allocations, count_solutions, cache_megabytes);
+    case 25:
+        return RunBench<Dimensions25>(path, engine, num_threads, warmup_runs, measured_runs, stats_path, check_allocations, count_solutions, cache_megabytes);
+    default:
+        return RunBench<Dimensions9>(path, engine, num_threads, warmup_runs, measured_runs, stats_path, check_allocations, count_solutions, cache_megabytes);
+    }
+}
+
+// Measure the solver on the puzzles of the file, with grids of the Dimensions. When counting, each
+// puzzle is checked for a unique solution instead, and the solved puzzles are the unique ones
+template <class Dimensions>
+int RunBench(const string& path, Engine engine, unsigned num_threads, int warmup_runs, int measured_runs,
+             const string& stats_path, bool check_allocations, bool count_solutions, size_t cache_megabytes) {
+    try {
+        vector<BasicPuzzle<Dimensions>> puzzles;
+        LoadPuzzles<Dimensions>(path, puzzles);
+        if (puzzles.empty()) {
+            cout << "Invalid input!" << endl;
+            return EXIT_FAILURE;
+        }
+
+        // The solver of the larger grids does not fit the stack
+        unique_ptr<BasicPuzzleSolver<Dimensions>> solver(new BasicPuzzleSolver<Dimensions>(engine));
+        // The cache is shared by the solver and the batch workers, and is warmed up like the caches of the CPU
+        unique_ptr<BasicSolutionCache<Dimensions>> cache;
+        if (cache_megabytes > 0) {
+            cache.reset(new BasicSolutionCache<Dimensions>(cache_megabytes << 20));
+            solver->SetSolutionCache(cache.get());
+        }
+        vector<BasicSolveResult<Dimensions>> results(puzzles.size());
+        vector<unsigned long> counts(puzzles.size());
+        unsigned long search_nodes = 0;
+
+        // Warm up the caches and the allocator before measuring
+        for (int run = 0; run < warmup_runs; run++) {
+            for (size_t i = 0; i < puzzles.size(); i++) {
+                if (count_solutions) {
+                    solver->CountSolutions(puzzles[i]);
+                } else {
+                    solver->Solve(puzzles[i], results[i]);
+                }
+            }
+        }
+        solver->ResetTechniqueStats();
+
+        vector<double> latencies;
+        latencies.reserve(puzzles.size() * measured_runs);
+        size_t success_count = 0;
+        double total_seconds = 0;
+        auto allocations = allocation_count.load();
+
+        for (int run = 0; run < measured_runs; run++) {
+            success_count = 0;
+            for (size_t i = 0; i < puzzles.size(); i++) {
+                auto start = chrono::steady_clock::now();
+                auto solved = count_solutions ? solver->CountSolutions(puzzles[i]) == 1 : solver->Solve(puzzles[i], results[i]);
+                auto end = chrono::steady_clock::now();
+
+                chrono::duration<double> elapsed = end - start;
+                latencies.push_back(elapsed.count() * 1e6);
+                total_seconds += elapsed.count();
+                if (solved) {
+                    success_count++;
+                }
+            }
+        }
+
+        allocations = allocation_count - allocations;
+
+        // Search nodes of the last measured run, before the batch runs solve into the same results
+        for (const auto& result : results) {
+            search_nodes += result.search_nodes;
+        }
+
+        // Solve the whole file as batches on the worker threads, measuring the throughput only. The batch
+        // has a cache of its own, warmed up by its own runs, so it starts from where the single thread did
+        double batch_seconds = 0;
+        unsigned batch_threads = 0;
+        if (num_threads > 0) {
+            BasicBatchSolver<Dimensions> batch_solver(engine, num_threads);
+            unique_ptr<BasicSolutionCache<Dimensions>> batch_cache;
+            if (cache_megabytes > 0) {
+                batch_cache.reset(new BasicSolutionCache<Dimensions>(cache_megabytes << 20));
+            }
+            batch_solver.SetSolutionCache(batch_cache.get());
+            batch_threads = batch_solver.GetThreadCount();
+            for (int run = 0; run < warmup_runs; run++) {
+                if (count_solutions) {
+                    batch_solver.CountBatch(puzzles, counts);
+                } else {
+                    batch_solver.SolveBatch(puzzles, results);
+                }
+            }
+
+            for (int run = 0; run < measured_runs; run++) {
+                auto start = chrono::steady_clock::now();
+                if (count_solutions) {
+                    batch_solver.CountBatch(puzzles, counts);
+                } else {
+                    batch_solver.SolveBatch(puzzles, results);
+                }
+                auto end = chrono::steady_clock::now();
+
+                chrono::duration<double> elapsed = end - start;
+                batch_seconds += elapsed.count();
+            }
+        }
+
+        sort(begin(latencies), end(latencies));
+        auto mean = accumulate(begin(latencies), end(latencies), 0.0) / latencies.size();
+
+        cout << fixed << setprecision(2);
+        cout << "Puzzles:      " << puzzles.size() << " (" << Dimensions::GRID_WIDTH << "x" << Dimensions::GRID_WIDTH << ")" << endl;
+        cout << "Kernel:       " << (GetSinglesKernel() == SinglesKernel::Avx2 ? "avx2" : "scalar") << endl;
+        cout << "Runs:         " << measured_runs << " (warmup " << warmup_runs << ")" << endl;
+        cout << (count_solutions ? "Unique:       " : "Solved:       ") << success_count << "/" << puzzles.size()
+             << " (" << 100.0 * success_count / puzzles.size() << "%)" << endl;
+        cout << "Throughput:   " << latencies.size() / total_seconds << " puzzles/sec" << endl;
+        cout << "Latency (us): mean " << mean
+             << "  p50 " << Percentile(latencies, 50)
+             << "  p99 " << Percentile(latencies, 99)
+             << "  max " << latencies.back() << endl;
+        if (batch_threads > 0) {
+            cout << "Batch:        " << puzzles.size() * measured_runs / batch_seconds << " puzzles/sec on "
+                 << batch_threads << " threads (" 
+                 << total_seconds / batch_seconds << "x)" << endl;
+        }
+        if (engine != Engine::Logic && !count_solutions) {
+            cout << "Search nodes: " << search_nodes << " (" 
+                 << static_cast<double>(search_nodes) / puzzles.size() << " per puzzle)" << endl;
+        }
+        if (cache) {
+            auto cache_stats = cache->GetStats();
+            cout << "Cache:        " << cache_stats.hits << "/" << cache_stats.lookups << " hits ("
+                 << 100.0 * cache_stats.GetHitRatio() << "%), " << cache_stats.skipped << " skipped, "
+                 << cache_stats.entries << "/" << cache_stats.capacity << " entries, "
+                 << cache_stats.memory_bytes / (1024.0 * 1024.0) << " MB" << endl;
+        }
+        cout << "Allocations:  " << allocations << " in the measured solves" << endl;
+        if (TechniqueStats::IsEnabled() && engine != Engine::DancingLinks) {
+            const auto& stats = solver->GetTechniqueStats();
+            for (size_t i = 0; i < NUM_TECHNIQUES; i++) {
+                auto technique = static_cast<Technique>(i);
+                const auto& counters = stats.GetCounters(technique);
+                cout << "  " << left << setw(16) << GetTechniqueName(technique) << right
+                     << " calls " << counters.calls << "  productive " << counters.productive_calls
+                     << "  eliminations " << counters.eliminations << "  placements " << counters.placements
+                     << "  time " << counters.nanoseconds / 1e6 << " ms" << endl;
+            }
+        }
+
+        if (!stats_path.empty()) {
+            WriteStats(stats_path, solver->GetTechniqueStats());
+        }
+
+        // The solve path must not allocate once the solver is set up
+        if (check_allocations && allocations > 0) {
+            cout << "The solver allocated from the heap while solving!" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const runtime_error& e) {
+        cout << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// Load the puzzles from the file, in either the Euler "Grid NN" block format,
+// the one puzzle per line format or the packed format
+template <class Dimensions>
+void LoadPuzzles(const string& path, vector<BasicPuzzle<Dimensions>>& puzzles) {
+    if (IsPackedPuzzleFile(path)) {
+        BasicPackedReader<Dimensions> packed_reader(path);
+        if (!packed_reader.HasPuzzles()) {
+            throw runtime_error("The packed file has no puzzles: " + path);
+        }
+        puzzles.resize(packed_reader.GetCount());
+        for (size_t i = 0; i < puzzles.size(); i++) {
+            packed_reader.GetPuzzle(i, puzzles[i]);
+        }
+        return;
+    }
+
+    BasicPuzzleReader<Dimensions> reader(path);
+    BasicPuzzleView<Dimensions> view;
+    while (reader.Next(view)) {
+        BasicPuzzle<Dimensions> puzzle;
+        view.CopyTo(puzzle);
+        puzzles.push_back(puzzle);
+    }
+}
+
+// Count the heap allocations; the array and nothrow forms call this one
+void* operator new(size_t size) {
+    allocation_count++;
+    if (auto memory = malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+// Write the counters of the techniques in the measured runs to the file as JSON
+void WriteStats(const string& path, const TechniqueStats& stats) {
+    if (!TechniqueStats::IsEnabled()) {
+        cerr << "Technique statistics are not recorded, build the library with SUDOKU_TECHNIQUE_STATS defined" << endl;
+    }
+
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("Can not write " + path);
+    }
+    stats.WriteJson(out);
+}
+
+// Return the latency at the given percentile of the sorted latencies
+double Percentile(const vector<double>& sorted_latencies, double percent) {
+    auto rank = static_cast<size_t>(percent / 100.0 * (sorted_latencies.size() - 1) + 0.5);
+    return sorted_latencies[min(rank, sorted_latencies.size() - 1)];
+}
@@ -21,70 +21,118 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cstdlib>
 
-#include "Grid.h"
+#include "BatchSolver.h"
+#include "PipelineSolver.h"
+#include "PuzzleReader.h"
+#include "PuzzleWriter.h"
 
 using namespace std;
 
 using namespace SudokuAlgorithm;
 
-void ParseRow(const string& row_str, vector<UShort>& row_nums);
+bool ParseEngine(const string& engine_str, Engine& engine);
+void WriteStats(const string& path, const TechniqueStats& stats);
+bool ReportSkippedLines(const PuzzleReader& reader);
 
 int main(int argc, char* argv[]) {
     try {
         if (argc > 1) {
-            string row_str;
-            vector<UShort> row_nums[GRID_WIDTH];
-            ifstream puzzle_stream;
-            
-            puzzle_stream.open(argv[1]);
-            UShort puzzle_count = 0;
-            UShort success_count = 0;
-            UShort line_count = 0;
-            while (getline(puzzle_stream, row_str)) {
-                if (row_str.compare(0, 4, "Grid") == 0) {
-                    puzzle_count++;
-                    cout << "PUZZLE: " << puzzle_count << endl;
+            Engine engine = Engine::Search;
+            unsigned num_threads = 0;
+            string stats_path;
+            bool count_solutions = false;
+            OutputFormat format = OutputFormat::Grid;
+            for (int i = 2; i < argc; i++) {
+                string arg = argv[i];
+                if (arg == "--engine" && i + 1 < argc && ParseEngine(argv[++i], engine)) {
                     continue;
                 }
-                
-                ParseRow(row_str, row_nums[line_count]);
-                if (row_nums[line_count].size() != GRID_WIDTH) {
-                    cout << "Invalid input!";
-                    return EXIT_FAILURE;
+                if (arg == "--threads" && i + 1 < argc) {
+                    num_threads = max(1, atoi(argv[++i]));
+                    continue;
+                }
+                if (arg == "--stats" && i + 1 < argc) {
+                    stats_path = argv[++i];
+                    continue;
+                }
+                if (arg == "--count") {
+                    count_solutions = true;
+                    continue;
                 }
-                if (++line_count == GRID_WIDTH) {
-                    line_count = 0;
-                    
-                    Grid grid;
-                    
-                    for (UShort i = 0; i < GRID_WIDTH; i++) {
-                        for (UShort j = 0; j < GRID_WIDTH; j++) {
-                            grid.UpdateCell(i, j, row_nums[i][j]);
-                        }
-                        
-                        row_nums[i].clear();
-                    }
-                    
-                    grid.DisplayGrid();
-                    
-                    if (grid.Solve()) {
-                        cout << endl << "Solution Successful!" << endl;
-                        grid.DisplayGrid();
-                        cout << endl;
-                        success_count++;
-                    }
-                    else {
-                        cout << endl << "Solution incomplete!" << endl;
-                        grid.DisplayGrid();
-                        cout << endl;
-                    }
+                if (arg == "--format" && i + 1 < argc && ParseOutputFormat(argv[++i], format)) {
+                    continue;
                 }
+
+                cout << "Usage: SudokuEulerProject <puzzle file> [--engine logic|search|dlx] [--threads N] [--stats <json file>] [--count] [--format grid|line|csv|none]" << endl;
+                return EXIT_FAILURE;
+            }
+
+            // The counts have no solution to write in a line or a row, and no techniques to record
+            if (count_solutions && (format == OutputFormat::Line || format == OutputFormat::Csv)) {
+                cout << "--count writes the grid or none format only" << endl;
+                return EXIT_FAILURE;
+            }
+            if (count_solutions && !stats_path.empty()) {
+                cout << "--count records no technique statistics, --stats is not allowed with it" << endl;
+                return EXIT_FAILURE;
             }
-            
-            cout << success_count << "/" << puzzle_count << " completed successfully!" << endl;
-            
-            return EXIT_SUCCESS;
+
+            // The results are written through one large buffer, flushed when it fills and at the end.
+            // An invalid puzzle is skipped, so the output of the others is complete, and reported at the end
+            ios::sync_with_stdio(false);
+            PuzzleReader reader(argv[1], PuzzleReader::InvalidPuzzles::Skip);
+            PuzzleWriter writer(cout, format, engine);
+
+            // Only check that each puzzle has exactly one solution, stopping the search at the second
+            if (count_solutions) {
+                // Views of the puzzles in the mapped file, without copying them
+                vector<PuzzleView> puzzles;
+                PuzzleView puzzle;
+                while (reader.Next(puzzle)) {
+                    puzzles.push_back(puzzle);
+                }
+
+                BatchSolver batch_solver(engine, num_threads);
+                vector<unsigned long> counts;
+                auto unique_count = batch_solver.CountBatch(puzzles, counts);
+
+                // The status of each puzzle, unless only the summary is wanted
+                for (size_t i = 0; i < puzzles.size() && format != OutputFormat::None; i++) {
+                    auto status = counts[i] == 0 ? "No solution!" : counts[i] == 1 ? "Unique solution!" : "Multiple solutions!";
+                    writer.WriteLine("PUZZLE: " + to_string(i + 1) + " " + status);
+                }
+
+                writer.WriteLine(to_string(unique_count) + "/" + to_string(puzzles.size()) + " have a unique solution!");
+                writer.Flush();
+                return ReportSkippedLines(reader) ? EXIT_FAILURE : EXIT_SUCCESS;
+            }
+
+            // Read, solve and write the puzzles in a pipeline, the results written in the order of the file
+            PipelineSolver pipeline(engine, num_threads);
+            size_t puzzle_count = 0;
+            auto success_count = pipeline.Run(reader, [&](size_t index, const PuzzleView& puzzle, const SolveResult& result) {
+                writer.Write(index, puzzle, result);
+                puzzle_count++;
+            });
+
+            // The summary is not a line or a row of the results, so it goes to the error stream for those formats
+            auto summary = to_string(success_count) + "/" + to_string(puzzle_count) + " completed successfully!";
+            if (format == OutputFormat::Line || format == OutputFormat::Csv) {
+                writer.Flush();
+                cerr << summary << endl;
+            } else {
+                writer.WriteLine(summary);
+                writer.Flush();
+            }
+
+            if (!stats_path.empty()) {
+                WriteStats(stats_path, pipeline.GetTechniqueStats());
+            }
+
+            return ReportSkippedLines(reader) ? EXIT_FAILURE : EXIT_SUCCESS;
         }
     }
     catch (const runtime_error& e) {
@@ -95,16 +143,39 @@ int main(int argc, char* argv[]) {
     return EXIT_SUCCESS;
 }
 
-// Parse the row numbers of the grid from the input string
-void ParseRow(const string& row_str, vector<UShort>& row_nums) {
-    for (auto c : row_str) {
-        if (isdigit(c)) {
-            row_nums.push_back(c - '0');
-        }
-        else if (isalpha(c)) {
-            if (c == 'x' || c == 'X') {
-                row_nums.push_back(0);
-            }
-        }
+// Parse the solving engine name
+bool ParseEngine(const string& engine_str, Engine& engine) {
+    if (engine_str == "logic") {
+        engine = Engine::Logic;
+    } else if (engine_str == "search") {
+        engine = Engine::Search;
+    } else if (engine_str == "dlx") {
+        engine = Engine::DancingLinks;
+    } else {
+        return false;
+    }
+    
+    return true;
+}
+
+// Write the counters of the techniques to the file as JSON
+void WriteStats(const string& path, const TechniqueStats& stats) {
+    if (!TechniqueStats::IsEnabled()) {
+        cerr << "Technique statistics are not recorded, build the library with SUDOKU_TECHNIQUE_STATS defined" << endl;
+    }
+
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("Can not write " + path);
     }
+    stats.WriteJson(out);
+}
+
+// Report the lines of the invalid puzzles the reader skipped, true if there were any
+bool ReportSkippedLines(const PuzzleReader& reader) {
+    for (auto line : reader.GetSkippedLines()) {
+        cerr << "Skipped the invalid puzzle at line " << line << endl;
+    }
+
+    return !reader.GetSkippedLines().empty();
 }
@@ -0,0 +1,180 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+// SudokuGenerator.cpp
+// SudokuGenerator
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+
+#include "PuzzleGenerator.h"
+#include "PuzzleReader.h"
+
+using namespace std;
+
+using namespace SudokuAlgorithm;
+
+template <class Dimensions>
+int RunGenerator(const string& minimize_path, size_t count, unsigned num_threads, unsigned long seed, Symmetry symmetry);
+template <class Dimensions>
+void WritePuzzle(const BasicPuzzle<Dimensions>& puzzle);
+
+int main(int argc, char* argv[]) {
+    size_t count = 10;
+    unsigned num_threads = 0;
+    unsigned long seed = 1;
+    Symmetry symmetry = Symmetry::None;
+    int size = 9;
+    string minimize_path;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc) {
+            count = max(1, atoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--symmetry" && i + 1 < argc) {
+            string symmetry_str = argv[++i];
+            if (symmetry_str == "none") {
+                symmetry = Symmetry::None;
+            } else if (symmetry_str == "rotational") {
+                symmetry = Symmetry::Rotational;
+            } else if (symmetry_str == "mirror") {
+                symmetry = Symmetry::Mirror;
+            } else {
+                cerr << "Unknown symmetry: " << symmetry_str << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--size" && i + 1 < argc) {
+            size = atoi(argv[++i]);
+            if (size != 6 && size != 9 && size != 16 && size != 25) {
+                cerr << "Unsupported size: " << argv[i] << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--minimize" && i + 1 < argc) {
+            minimize_path = argv[++i];
+        } else {
+            cerr << "Usage: sudoku_generator [--count N] [--threads N] [--seed N] [--symmetry none|rotational|mirror] [--size 6|9|16|25] [--minimize <puzzle file>]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (num_threads == 0) {
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+
+    switch (size) {
+    case 6:
+        return RunGenerator<Dimensions6>(minimize_path, count, num_threads, seed, symmetry);
+    case 16:
+        return RunGenerator<Dimensions16>(minimize_path, count, num_threads, seed, symmetry);
+    case 25:
+        return RunGenerator<Dimensions25>(minimize_path, count, num_threads, seed, symmetry);
+    default:
+        return RunGenerator<Dimensions9>(minimize_path, count, num_threads, seed, symmetry);
+    }
+}
+
+// Generate count puzzles, or minimize the puzzles of the file, on the worker threads, and write them
+// one per line in order. The puzzle at index i is made from the seed plus i, whatever thread makes it
+template <class Dimensions>
+int RunGenerator(const string& minimize_path, size_t count, unsigned num_threads, unsigned long seed, Symmetry symmetry) {
+    vector<BasicPuzzle<Dimensions>> puzzles;
+    try {
+        if (!minimize_path.empty()) {
+            BasicPuzzleReader<Dimensions> reader(minimize_path);
+            BasicPuzzleView<Dimensions> view;
+            while (reader.Next(view)) {
+                BasicPuzzle<Dimensions> puzzle;
+                view.CopyTo(puzzle);
+                puzzles.push_back(puzzle);
+            }
+        } else {
+            puzzles.resize(count);
+        }
+    }
+    catch (const runtime_error& e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    atomic<size_t> next_puzzle(0);
+    atomic<size_t> not_unique_count(0);
+    atomic<unsigned long> uniqueness_checks(0);
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> workers;
+    for (unsigned i = 0; i < num_threads; i++) {
+        workers.emplace_back([&] {
+            // The generators of the larger grids do not fit the stack
+            unique_ptr<BasicPuzzleGenerator<Dimensions>> generator(new BasicPuzzleGenerator<Dimensions>());
+            for (auto index = next_puzzle++; index < puzzles.size(); index = next_puzzle++) {
+                generator->Seed(seed + index);
+                if (minimize_path.empty()) {
+                    generator->Generate(puzzles[index], symmetry);
+                } else if (!generator->Minimize(puzzles[index], symmetry)) {
+                    not_unique_count++;
+                }
+            }
+            uniqueness_checks += generator->GetUniquenessChecks();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    size_t clue_count = 0;
+    for (const auto& puzzle : puzzles) {
+        WritePuzzle<Dimensions>(puzzle);
+        clue_count += count_if(begin(puzzle), end(puzzle), [](UShort num) { return num != 0; });
+    }
+
+    // The report goes to the error stream, to keep the puzzles apart
+    cerr << fixed << setprecision(2);
+    cerr << (minimize_path.empty() ? "Generated " : "Minimized ") << puzzles.size() << " puzzles ("
+         << Dimensions::GRID_WIDTH << "x" << Dimensions::GRID_WIDTH << ") in " << elapsed.count() << " s on "
+         << num_threads << " threads: " << puzzles.size() / elapsed.count() << " puzzles/sec" << endl;
+    if (!puzzles.empty()) {
+        cerr << "Clues:        " << static_cast<double>(clue_count) / puzzles.size() << " per puzzle" << endl;
+        cerr << "Checks:       " << static_cast<double>(uniqueness_checks) / puzzles.size() << " uniqueness checks per puzzle" << endl;
+    }
+    if (not_unique_count > 0) {
+        cerr << not_unique_count << " puzzles without a unique solution were left as they are" << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// Write the puzzle on one line, with 0 for the empty cells
+template <class Dimensions>
+void WritePuzzle(const BasicPuzzle<Dimensions>& puzzle) {
+    string line;
+    for (auto num : puzzle) {
+        line += GetNumberChar(num);
+    }
+    cout << line << '\n';
+}
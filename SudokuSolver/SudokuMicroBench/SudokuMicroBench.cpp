@@ -0,0 +1,470 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+// SudokuMicroBench.cpp
+// SudokuMicroBench
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <limits>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Grid.h"
+
+using namespace std;
+
+using namespace SudokuAlgorithm;
+
+// Grid states pinned for the technique benchmarks. The clues state has the numbers only, as the
+// segments find it before they are initialized, and the candidates state is ready for the techniques
+struct Fixture {
+    string name;
+    GridState clues;
+    GridState candidates;
+};
+
+// Time and instructions of one batch of calls; no instructions where the counter is not available
+struct Measurement {
+    double nanoseconds;
+    double instructions;
+};
+
+struct Options {
+    string filter;
+    double min_seconds = 0.1;
+    int repeats = 5;
+};
+
+// Instructions retired by the thread in user mode, from the hardware counter where the kernel provides it
+class InstructionCounter final {
+public:
+    InstructionCounter();
+    InstructionCounter(const InstructionCounter&) = delete;
+    InstructionCounter& operator= (const InstructionCounter&) = delete;
+
+    ~InstructionCounter();
+
+    bool IsAvailable() const {
+        return fd_ >= 0;
+    }
+
+    void Start();
+    // Instructions since Start
+    uint64_t Stop();
+
+private:
+    int fd_ = -1;
+};
+
+// The puzzles of the fixtures, one easy one that the techniques solve,
+// and one hard one that stalls the techniques with 31 cells filled
+const char* const EASY_PUZZLE = "031607000600800257800090603400000832010069000703240006902401078085000009304000061";
+const char* const HARD_PUZZLE = "083000000004050000000000320000800031050097800000004070030001900000200000500048100";
+
+// The results of the calls are added here, so the compiler can not leave the calls out
+volatile unsigned long result_sink = 0;
+
+void MakeFixture(const string& name, const char* puzzle, bool stall, Fixture& fixture);
+void RunMarkingBenchmarks(const Options& options, InstructionCounter& counter);
+template <class Operation>
+void RunMarkingBenchmark(const string& name, const vector<Marking>& markings, Operation operation,
+                         const Options& options, InstructionCounter& counter);
+void RunSegmentBenchmarks(const Fixture& fixture, const Options& options, InstructionCounter& counter);
+template <class Call>
+void RunSegmentBenchmark(const string& name, GridState& state, const GridState& start, const vector<Segment*>& segments,
+                         Call call, const Measurement& restore, const Options& options, InstructionCounter& counter);
+void RunGridBenchmarks(const Fixture& fixture, const Options& options, InstructionCounter& counter);
+template <class Call>
+void RunGridBenchmark(const string& name, Grid& grid, const GridState& start, Call call, const Measurement& restore,
+                      const Options& options, InstructionCounter& counter);
+template <class Function>
+Measurement Measure(Function batch, const Options& options, InstructionCounter& counter);
+void Report(const string& name, const Measurement& measurement, const Measurement& overhead, double calls_per_batch);
+bool IsSelected(const string& name, const Options& options);
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.min_seconds = max(1, atoi(argv[++i])) / 1000.0;
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            options.repeats = max(1, atoi(argv[++i]));
+        } else {
+            cout << "Usage: sudoku_microbench [--filter <text>] [--min-time <ms>] [--repeat N]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    vector<Fixture> fixtures(3);
+    MakeFixture("easy/initial", EASY_PUZZLE, false, fixtures[0]);
+    MakeFixture("hard/initial", HARD_PUZZLE, false, fixtures[1]);
+    MakeFixture("hard/stalled", HARD_PUZZLE, true, fixtures[2]);
+
+    InstructionCounter counter;
+    cout << "Each benchmark takes the fastest of " << options.repeats << " runs of at least "
+         << options.min_seconds * 1000 << " ms, net of restoring the fixture state" << endl;
+    if (!counter.IsAvailable()) {
+        cout << "The instruction counter is not available" << endl;
+    }
+    cout << endl << left << setw(56) << "Benchmark" << right << setw(12) << "ns/op" << setw(18) << "instructions/op" << endl;
+
+    RunMarkingBenchmarks(options, counter);
+    for (const auto& fixture : fixtures) {
+        RunSegmentBenchmarks(fixture, options, counter);
+        RunGridBenchmarks(fixture, options, counter);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// Pin the state of the puzzle: its clues with the candidates of the segments initialized, or where
+// the techniques stall when stall is set, with the numbers they solved as the clues
+void MakeFixture(const string& name, const char* puzzle, bool stall, Fixture& fixture) {
+    fixture.name = name;
+
+    unique_ptr<Grid> grid(new Grid());
+    for (UShort cell = 0; cell < Grid::NUM_GRID_CELLS; cell++) {
+        auto num = GetCharNumber(puzzle[cell]);
+        grid->UpdateCell(cell / Grid::GRID_WIDTH, cell % Grid::GRID_WIDTH, num);
+    }
+    if (stall) {
+        grid->Solve(SolveMode::Logic);
+    }
+
+    for (UShort cell = 0; cell < Grid::NUM_GRID_CELLS; cell++) {
+        fixture.clues.SetNumber(cell, grid->GetCellNumber(cell / Grid::GRID_WIDTH, cell % Grid::GRID_WIDTH));
+    }
+
+    fixture.candidates = fixture.clues;
+    for (UShort n = 0; n < Grid::GRID_WIDTH; n++) {
+        Row(n, fixture.candidates).Initialize();
+        Column(n, fixture.candidates).Initialize();
+        Block(n, fixture.candidates).Initialize();
+    }
+    fixture.candidates.QueueAllSegments();
+}
+
+// Time the Marking primitives over every candidate mask, and the loops over the bits they replaced
+void RunMarkingBenchmarks(const Options& options, InstructionCounter& counter) {
+    // Every mask once, in a scrambled but fixed order
+    const size_t NUM_MASKS = size_t(1) << Grid::NUM_BASE;
+    vector<Marking> markings(NUM_MASKS);
+    for (size_t i = 0; i < NUM_MASKS; i++) {
+        markings[i] = Marking(static_cast<Marking::Mask>((i * 317) % NUM_MASKS));
+    }
+
+    RunMarkingBenchmark("Marking::GetCount", markings, [](const Marking& marking, const Marking&) {
+        return marking.GetCount();
+    }, options, counter);
+
+    RunMarkingBenchmark("Marking::GetCount, bit loop", markings, [](const Marking& marking, const Marking&) {
+        UShort count = 0;
+        for (UShort n = 1; n <= Grid::NUM_BASE; n++) {
+            if (marking.IsMarked(n)) {
+                count++;
+            }
+        }
+        return count;
+    }, options, counter);
+
+    RunMarkingBenchmark("Marking::GetResolvedNumber", markings, [](const Marking& marking, const Marking&) {
+        return marking.GetResolvedNumber();
+    }, options, counter);
+
+    RunMarkingBenchmark("Marking::GetResolvedNumber, bit loop", markings, [](const Marking& marking, const Marking&) {
+        UShort count = 0;
+        UShort number = 0;
+        for (UShort n = 1; n <= Grid::NUM_BASE; n++) {
+            if (marking.IsMarked(n)) {
+                count++;
+                number = n;
+            }
+        }
+        return count == 1 ? number : 0;
+    }, options, counter);
+
+    RunMarkingBenchmark("Marking::GetLowestNumber", markings, [](const Marking& marking, const Marking&) {
+        return marking.GetLowestNumber();
+    }, options, counter);
+
+    RunMarkingBenchmark("Marking iteration", markings, [](const Marking& marking, const Marking&) {
+        unsigned long sum = 0;
+        for (auto n : marking) {
+            sum += n;
+        }
+        return sum;
+    }, options, counter);
+
+    RunMarkingBenchmark("Marking::MatchSubset", markings, [](const Marking& marking, const Marking& other) {
+        return marking.MatchSubset(other).GetNumbers();
+    }, options, counter);
+
+    RunMarkingBenchmark("Marking::Erase(subset)", markings, [](const Marking& marking, const Marking& other) {
+        auto erased = marking;
+        return erased.Erase(other) ? erased.GetNumbers() : 0;
+    }, options, counter);
+}
+
+// Time the operation on each marking and the one after it
+template <class Operation>
+void RunMarkingBenchmark(const string& name, const vector<Marking>& markings, Operation operation,
+                         const Options& options, InstructionCounter& counter) {
+    if (!IsSelected(name, options)) {
+        return;
+    }
+
+    auto measurement = Measure([&] {
+        unsigned long sum = 0;
+        for (size_t i = 0; i < markings.size(); i++) {
+            sum += operation(markings[i], markings[(i + 1) % markings.size()]);
+        }
+        result_sink = sum;
+    }, options, counter);
+
+    Report(name, measurement, Measurement{0, 0}, static_cast<double>(markings.size()));
+}
+
+// Time the initialization and the techniques of the segments on the fixture, a call for each segment
+void RunSegmentBenchmarks(const Fixture& fixture, const Options& options, InstructionCounter& counter) {
+    // The segments refer the state, which is restored from the fixture before each batch
+    GridState state;
+    vector<unique_ptr<Segment>> owners;
+    vector<Segment*> rows, columns, blocks, segments;
+    for (UShort n = 0; n < Grid::GRID_WIDTH; n++) {
+        owners.emplace_back(new Row(n, state));
+        rows.push_back(owners.back().get());
+        owners.emplace_back(new Column(n, state));
+        columns.push_back(owners.back().get());
+        owners.emplace_back(new Block(n, state));
+        blocks.push_back(owners.back().get());
+    }
+    segments.insert(segments.end(), rows.begin(), rows.end());
+    segments.insert(segments.end(), columns.begin(), columns.end());
+    segments.insert(segments.end(), blocks.begin(), blocks.end());
+
+    auto suffix = " [" + fixture.name + "]";
+    auto restore = Measure([&] {
+        state = fixture.candidates;
+        result_sink = state.GetNumber(0);
+    }, options, counter);
+    if (IsSelected("GridState restore" + suffix, options)) {
+        Report("GridState restore" + suffix, restore, Measurement{0, 0}, 1);
+    }
+
+    auto initialize = [](Segment& segment) {
+        segment.Initialize();
+        return 0;
+    };
+    RunSegmentBenchmark("Row::Initialize" + suffix, state, fixture.clues, rows, initialize, restore, options, counter);
+    RunSegmentBenchmark("Column::Initialize" + suffix, state, fixture.clues, columns, initialize, restore, options, counter);
+    RunSegmentBenchmark("Block::Initialize" + suffix, state, fixture.clues, blocks, initialize, restore, options, counter);
+
+    auto intersections = [](Segment& segment) {
+        return segment.SolveIntersections();
+    };
+    RunSegmentBenchmark("Row::SolveIntersections" + suffix, state, fixture.candidates, rows, intersections, restore, options, counter);
+    RunSegmentBenchmark("Column::SolveIntersections" + suffix, state, fixture.candidates, columns, intersections, restore, options, counter);
+    RunSegmentBenchmark("Block::SolveIntersections" + suffix, state, fixture.candidates, blocks, intersections, restore, options, counter);
+
+    RunSegmentBenchmark("Segment::SolveVisibleSubsets" + suffix, state, fixture.candidates, segments, [](Segment& segment) {
+        return segment.SolveVisibleSubsets();
+    }, restore, options, counter);
+    RunSegmentBenchmark("Segment::SolveHiddenSubsets" + suffix, state, fixture.candidates, segments, [](Segment& segment) {
+        return segment.SolveHiddenSubsets();
+    }, restore, options, counter);
+}
+
+// Time the call on each of the segments, from the start state restored before each batch
+template <class Call>
+void RunSegmentBenchmark(const string& name, GridState& state, const GridState& start, const vector<Segment*>& segments,
+                         Call call, const Measurement& restore, const Options& options, InstructionCounter& counter) {
+    if (!IsSelected(name, options)) {
+        return;
+    }
+
+    auto measurement = Measure([&] {
+        state = start;
+        unsigned long sum = 0;
+        for (auto segment : segments) {
+            sum += call(*segment);
+        }
+        result_sink = sum;
+    }, options, counter);
+
+    Report(name, measurement, restore, static_cast<double>(segments.size()));
+}
+
+// Time the techniques of the whole grid on the fixture
+void RunGridBenchmarks(const Fixture& fixture, const Options& options, InstructionCounter& counter) {
+    unique_ptr<Grid> grid(new Grid());
+
+    auto suffix = " [" + fixture.name + "]";
+    auto restore = Measure([&] {
+        grid->RestoreSnapshot(fixture.candidates);
+        result_sink = grid->GetCellNumber(0, 0);
+    }, options, counter);
+    if (IsSelected("Grid::RestoreSnapshot" + suffix, options)) {
+        Report("Grid::RestoreSnapshot" + suffix, restore, Measurement{0, 0}, 1);
+    }
+
+    RunGridBenchmark("Grid::SolveFish" + suffix, *grid, fixture.candidates, [](Grid& g) {
+        return g.SolveFish();
+    }, restore, options, counter);
+    RunGridBenchmark("Grid::SolveXYWing" + suffix, *grid, fixture.candidates, [](Grid& g) {
+        return g.SolveXYWing();
+    }, restore, options, counter);
+    RunGridBenchmark("Grid::SolveXYZWing" + suffix, *grid, fixture.candidates, [](Grid& g) {
+        return g.SolveXYZWing();
+    }, restore, options, counter);
+    RunGridBenchmark("Grid::SolveSimpleColoring" + suffix, *grid, fixture.candidates, [](Grid& g) {
+        return g.SolveSimpleColoring();
+    }, restore, options, counter);
+}
+
+// Time the call on the grid, from the start state restored before each call
+template <class Call>
+void RunGridBenchmark(const string& name, Grid& grid, const GridState& start, Call call, const Measurement& restore,
+                      const Options& options, InstructionCounter& counter) {
+    if (!IsSelected(name, options)) {
+        return;
+    }
+
+    auto measurement = Measure([&] {
+        grid.RestoreSnapshot(start);
+        result_sink = call(grid);
+    }, options, counter);
+
+    Report(name, measurement, restore, 1);
+}
+
+// Run the batch for at least the minimum time, and take the fastest of the repeated runs.
+// The number of batches of a run is found from a short calibration run
+template <class Function>
+Measurement Measure(Function batch, const Options& options, InstructionCounter& counter) {
+    unsigned long batches = 1;
+    for (;;) {
+        auto start = chrono::steady_clock::now();
+        for (unsigned long i = 0; i < batches; i++) {
+            batch();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        if (elapsed.count() >= options.min_seconds / 10) {
+            batches = max(1ul, static_cast<unsigned long>(batches * options.min_seconds / elapsed.count()));
+            break;
+        }
+        batches *= 2;
+    }
+
+    Measurement best = {numeric_limits<double>::max(), numeric_limits<double>::max()};
+    for (int run = 0; run < options.repeats; run++) {
+        counter.Start();
+        auto start = chrono::steady_clock::now();
+        for (unsigned long i = 0; i < batches; i++) {
+            batch();
+        }
+        auto end = chrono::steady_clock::now();
+        auto instructions = counter.Stop();
+
+        chrono::duration<double, nano> elapsed = end - start;
+        best.nanoseconds = min(best.nanoseconds, elapsed.count() / batches);
+        best.instructions = min(best.instructions, static_cast<double>(instructions) / batches);
+    }
+
+    if (!counter.IsAvailable()) {
+        best.instructions = -1;
+    }
+    return best;
+}
+
+// Write the time and the instructions of a call, net of the overhead of the batch
+void Report(const string& name, const Measurement& measurement, const Measurement& overhead, double calls_per_batch) {
+    cout << left << setw(56) << name << right << fixed << setprecision(2)
+         << setw(12) << max(0.0, measurement.nanoseconds - overhead.nanoseconds) / calls_per_batch;
+    if (measurement.instructions < 0) {
+        cout << setw(18) << "n/a";
+    } else {
+        cout << setw(18) << max(0.0, measurement.instructions - overhead.instructions) / calls_per_batch;
+    }
+    cout << endl;
+}
+
+// Check the name of the benchmark against the filter, all of them for no filter
+bool IsSelected(const string& name, const Options& options) {
+    return options.filter.empty() || name.find(options.filter) != string::npos;
+}
+
+InstructionCounter::InstructionCounter() {
+#ifdef __linux__
+    perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+}
+
+InstructionCounter::~InstructionCounter() {
+#ifdef __linux__
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+#endif
+}
+
+void InstructionCounter::Start() {
+#ifdef __linux__
+    if (fd_ >= 0) {
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+// Instructions since Start
+uint64_t InstructionCounter::Stop() {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (fd_ >= 0) {
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+            count = 0;
+        }
+    }
+#endif
+    return count;
+}
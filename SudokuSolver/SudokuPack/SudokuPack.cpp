@@ -0,0 +1,228 @@
+// Copyright 2018 Vijayakumar Balakrishnan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+// SudokuPack.cpp
+// SudokuPack
+//
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+
+#include "BatchSolver.h"
+#include "PackedPuzzles.h"
+#include "PuzzleReader.h"
+
+using namespace std;
+
+using namespace SudokuAlgorithm;
+
+template <class Dimensions>
+int Pack(const string& input_path, const string& output_path, PackedContent content, Engine engine, unsigned num_threads);
+template <class Dimensions>
+int Unpack(const string& input_path, const string& output_path);
+template <class Dimensions>
+void AppendLine(const BasicPuzzle<Dimensions>& puzzle, string& text);
+long long GetFileSize(const string& path);
+
+// Text collected before it is written to the output file
+const size_t TEXT_BUFFER_SIZE = 1 << 20;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: sudoku_pack <input file> <output file> [--unpack] [--content puzzles|solutions|both] [--engine logic|search|dlx] [--threads N] [--size 6|9|16|25]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    string input_path = argv[1];
+    string output_path = argv[2];
+    bool unpack = false;
+    PackedContent content = PackedContent::Puzzles;
+    Engine engine = Engine::Search;
+    unsigned num_threads = 0;
+    int size = 9;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--unpack") {
+            unpack = true;
+        } else if (arg == "--content" && i + 1 < argc) {
+            string content_str = argv[++i];
+            if (content_str == "puzzles") {
+                content = PackedContent::Puzzles;
+            } else if (content_str == "solutions") {
+                content = PackedContent::Solutions;
+            } else if (content_str == "both") {
+                content = PackedContent::PuzzlesAndSolutions;
+            } else {
+                cerr << "Unknown content: " << content_str << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--engine" && i + 1 < argc) {
+            string engine_str = argv[++i];
+            if (engine_str == "logic") {
+                engine = Engine::Logic;
+            } else if (engine_str == "search") {
+                engine = Engine::Search;
+            } else if (engine_str == "dlx") {
+                engine = Engine::DancingLinks;
+            } else {
+                cerr << "Unknown engine: " << engine_str << endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--size" && i + 1 < argc) {
+            size = atoi(argv[++i]);
+            if (size != 6 && size != 9 && size != 16 && size != 25) {
+                cerr << "Unsupported size: " << argv[i] << endl;
+                return EXIT_FAILURE;
+            }
+        } else {
+            cerr << "Unknown option: " << arg << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        switch (size) {
+        case 6:
+            return unpack ? Unpack<Dimensions6>(input_path, output_path) :
+                Pack<Dimensions6>(input_path, output_path, content, engine, num_threads);
+        case 16:
+            return unpack ? Unpack<Dimensions16>(input_path, output_path) :
+                Pack<Dimensions16>(input_path, output_path, content, engine, num_threads);
+        case 25:
+            return unpack ? Unpack<Dimensions25>(input_path, output_path) :
+                Pack<Dimensions25>(input_path, output_path, content, engine, num_threads);
+        default:
+            return unpack ? Unpack<Dimensions9>(input_path, output_path) :
+                Pack<Dimensions9>(input_path, output_path, content, engine, num_threads);
+        }
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+}
+
+// Pack the puzzles of the text file. The solutions are solved on the worker threads when the content
+// has them, and every puzzle must have one
+template <class Dimensions>
+int Pack(const string& input_path, const string& output_path, PackedContent content, Engine engine, unsigned num_threads) {
+    vector<BasicPuzzle<Dimensions>> puzzles;
+    BasicPuzzleReader<Dimensions> reader(input_path);
+    BasicPuzzleView<Dimensions> view;
+    while (reader.Next(view)) {
+        BasicPuzzle<Dimensions> puzzle;
+        view.CopyTo(puzzle);
+        puzzles.push_back(puzzle);
+    }
+
+    vector<BasicSolveResult<Dimensions>> results;
+    if (content != PackedContent::Puzzles) {
+        BasicBatchSolver<Dimensions> solver(engine, num_threads);
+        solver.SolveBatch(puzzles, results);
+        for (size_t i = 0; i < results.size(); i++) {
+            if (!results[i].solved) {
+                cerr << "Puzzle " << i + 1 << " has no solution" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    BasicPackedWriter<Dimensions> writer(output_path, content);
+    for (size_t i = 0; i < puzzles.size(); i++) {
+        if (content == PackedContent::PuzzlesAndSolutions) {
+            writer.Write(puzzles[i], results[i].solution);
+        } else {
+            writer.Write(content == PackedContent::Puzzles ? puzzles[i] : results[i].solution);
+        }
+    }
+    writer.Close();
+
+    auto text_size = GetFileSize(input_path);
+    auto packed_size = GetFileSize(output_path);
+    cerr << "Packed " << puzzles.size() << " puzzles into " << packed_size << " bytes, "
+         << BasicPackedFormat<Dimensions>::GetRecordSize(content) << " bytes per record";
+    if (packed_size > 0) {
+        cerr << ", " << static_cast<double>(text_size) / packed_size << "x smaller than the text";
+    }
+    cerr << endl;
+
+    return EXIT_SUCCESS;
+}
+
+// Write the records of the packed file one per line: the puzzle or the solution, or the puzzle and
+// the solution separated by a comma. The puzzle file reader reads the puzzles of the lines back, and
+// skips the solution after the comma, so a file of solutions only is read back as complete puzzles
+template <class Dimensions>
+int Unpack(const string& input_path, const string& output_path) {
+    BasicPackedReader<Dimensions> reader(input_path);
+    ofstream out(output_path, ios::binary | ios::trunc);
+    if (!out) {
+        cerr << "Can not write " << output_path << endl;
+        return EXIT_FAILURE;
+    }
+
+    string text;
+    BasicPuzzle<Dimensions> grid;
+    for (size_t i = 0; i < reader.GetCount(); i++) {
+        if (reader.HasPuzzles()) {
+            reader.GetPuzzle(i, grid);
+            AppendLine<Dimensions>(grid, text);
+        }
+        if (reader.HasSolutions()) {
+            if (reader.HasPuzzles()) {
+                text += ',';
+            }
+            reader.GetSolution(i, grid);
+            AppendLine<Dimensions>(grid, text);
+        }
+        text += '\n';
+
+        if (text.size() >= TEXT_BUFFER_SIZE) {
+            out.write(text.data(), text.size());
+            text.clear();
+        }
+    }
+    out.write(text.data(), text.size());
+
+    if (!out.flush()) {
+        cerr << "Can not write " << output_path << endl;
+        return EXIT_FAILURE;
+    }
+
+    cerr << "Unpacked " << reader.GetCount() << " records" << endl;
+    return EXIT_SUCCESS;
+}
+
+// Add the numbers of the grid on one line, with 0 for the empty cells
+template <class Dimensions>
+void AppendLine(const BasicPuzzle<Dimensions>& puzzle, string& text) {
+    for (auto num : puzzle) {
+        text += GetNumberChar(num);
+    }
+}
+
+// Size of the file in bytes, -1 if it can not be read
+long long GetFileSize(const string& path) {
+    ifstream in(path, ios::binary | ios::ate);
+    return in ? static_cast<long long>(in.tellg()) : -1;
+}
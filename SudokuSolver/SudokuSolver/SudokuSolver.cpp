@@ -21,18 +21,111 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 #include "Grid.h"
+#include "PuzzleSolver.h"
 
 using namespace std;
 
 using namespace SudokuAlgorithm;
 
 void ParseRow(const string& row_str, vector<UShort>& row_nums);
+int Serve(const string& socket_path, Engine engine, unsigned num_threads, size_t cache_megabytes);
+#ifndef _WIN32
+// Connection of a client. The event loop reads its requests and writes its answers, and hands
+// the complete request lines to a worker, one batch at a time so the answers stay in order
+struct Connection {
+    int socket;
+    // Bytes read and not yet handed to a worker, and answers not yet written
+    string input;
+    string output;
+    // A worker answers a batch of the requests
+    bool busy = false;
+    // The client closed its side; the answers of its requests are still written
+    bool closed = false;
+    // A read or write failed, so there is no one to answer
+    bool failed = false;
+    // The rest of a line too long to be a puzzle, already answered
+    bool discarding = false;
+};
+
+// Complete request lines of a connection, and their answers
+struct Batch {
+    int socket;
+    string requests;
+    string responses;
+};
+
+bool TakeBatch(Connection& connection, Batch& batch);
+void ReadRequests(Connection& connection);
+void WriteAnswers(Connection& connection);
+void AnswerBatch(Batch& batch, PuzzleSolver& solver);
+void AnswerRequest(const char* line, size_t length, PuzzleSolver& solver, string& response);
+bool SetNonBlocking(int socket);
+#endif
 
 int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        string socket_path;
+        Engine engine = Engine::Search;
+        unsigned num_threads = 0;
+        size_t cache_megabytes = 0;
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--serve" && i + 1 < argc) {
+                socket_path = argv[++i];
+            } else if (arg == "--threads" && i + 1 < argc) {
+                num_threads = max(1, atoi(argv[++i]));
+            } else if (arg == "--cache" && i + 1 < argc) {
+                cache_megabytes = max(1, atoi(argv[++i]));
+            } else if (arg == "--engine" && i + 1 < argc) {
+                string engine_str = argv[++i];
+                if (engine_str == "logic") {
+                    engine = Engine::Logic;
+                } else if (engine_str == "search") {
+                    engine = Engine::Search;
+                } else if (engine_str == "dlx") {
+                    engine = Engine::DancingLinks;
+                } else {
+                    socket_path.clear();
+                    break;
+                }
+            } else {
+                socket_path.clear();
+                break;
+            }
+        }
+
+        if (socket_path.empty()) {
+            cout << "Usage: SudokuSolver [--serve <socket path> [--threads N] [--engine logic|search|dlx] [--cache <MB>]]" << endl;
+            return EXIT_FAILURE;
+        }
+
+        return Serve(socket_path, engine, num_threads, cache_megabytes);
+    }
+
     string row_str;
-    vector<UShort> row_nums[GRID_WIDTH];
+    vector<UShort> row_nums[Grid::GRID_WIDTH];
 	
     cout << "Enter the numbers row-wise." << endl;
     cout << "Enter X for blank cells." << endl;
@@ -47,10 +140,10 @@ int main(int argc, char* argv[]) {
     cout << "X 8 5 X X X X X 9" << endl;
     cout << "3 X 4 X X X X 6 1" << endl << endl;
     
-    for (UShort i=0; i<GRID_WIDTH; i++) {
+    for (UShort i=0; i<Grid::GRID_WIDTH; i++) {
 		getline(cin, row_str);
         ParseRow(row_str, row_nums[i]);
-        if (row_nums[i].size() != GRID_WIDTH) {
+        if (row_nums[i].size() != Grid::GRID_WIDTH) {
             cout << "Invalid input!";
             return EXIT_FAILURE;
         }
@@ -59,8 +152,8 @@ int main(int argc, char* argv[]) {
     try {
         Grid grid;
         
-        for (UShort i=0; i<GRID_WIDTH; i++) {
-            for (UShort j=0; j<GRID_WIDTH; j++) {
+        for (UShort i=0; i<Grid::GRID_WIDTH; i++) {
+            for (UShort j=0; j<Grid::GRID_WIDTH; j++) {
                 grid.UpdateCell(i, j, row_nums[i][j]);
             }
         }
@@ -69,7 +162,7 @@ int main(int argc, char* argv[]) {
             cout << endl << "Solution Successful!" << endl;
             grid.DisplayGrid();
         } else {
-            cout << endl << "Solution incomplete!" << endl;
+            cout << endl << "No solution!" << endl;
             grid.DisplayGrid();
             return EXIT_FAILURE;
         }
@@ -95,3 +188,317 @@ void ParseRow(const string& rowStr, vector<UShort>& rowNums) {
 		}
 	}
 }
+
+#ifdef _WIN32
+// Unix domain sockets are not available
+int Serve(const string&, Engine, unsigned, size_t) {
+    cout << "The server mode is not supported on Windows" << endl;
+    return EXIT_FAILURE;
+}
+#else
+// Longest line read before it is answered as INVALID, and the answers kept for a connection
+// before its requests are no longer read, until the client reads them
+const size_t MAX_REQUEST_SIZE = 64*1024;
+const size_t MAX_OUTPUT_SIZE = 1024*1024;
+
+// Listen on the Unix domain socket and answer the puzzles of the connections. One event loop polls the
+// listener and every connection, reads the requests and writes the answers without blocking, and hands
+// the complete lines of a connection to the worker threads as a batch. Each worker has its own solver,
+// reused for every puzzle, and never waits on a socket, so an idle connection holds no worker.
+// With a cache, the workers share the solutions of the puzzles answered so far
+int Serve(const string& socket_path, Engine engine, unsigned num_threads, size_t cache_megabytes) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        cout << "Socket path is too long: " << socket_path << endl;
+        return EXIT_FAILURE;
+    }
+    strcpy(address.sun_path, socket_path.c_str());
+
+    // A socket left by an earlier server is replaced, but never any other file
+    struct stat status;
+    if (lstat(socket_path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(socket_path.c_str());
+    }
+
+    auto listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 ||
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0 || !SetNonBlocking(listener)) {
+        cout << "Can not listen on " << socket_path << ": " << strerror(errno) << endl;
+        return EXIT_FAILURE;
+    }
+
+    // The workers wake the event loop through the pipe when they have answered a batch
+    int wake_pipe[2];
+    if (pipe(wake_pipe) != 0 || !SetNonBlocking(wake_pipe[0]) || !SetNonBlocking(wake_pipe[1])) {
+        cout << "Can not create the wake pipe: " << strerror(errno) << endl;
+        return EXIT_FAILURE;
+    }
+
+    // A client closing early must not stop the server
+    signal(SIGPIPE, SIG_IGN);
+
+    if (num_threads == 0) {
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+
+    unique_ptr<SolutionCache> cache;
+    if (cache_megabytes > 0) {
+        cache.reset(new SolutionCache(cache_megabytes << 20));
+    }
+
+    // Batches waiting for a worker, and the batches answered, waiting for the event loop
+    mutex batches_mutex;
+    condition_variable batch_ready;
+    deque<Batch> pending_batches;
+    deque<Batch> answered_batches;
+
+    vector<thread> workers;
+    for (unsigned i = 0; i < num_threads; i++) {
+        workers.emplace_back([&, engine] {
+            unique_ptr<PuzzleSolver> solver(new PuzzleSolver(engine));
+            solver->SetSolutionCache(cache.get());
+            for (;;) {
+                Batch batch;
+                {
+                    unique_lock<mutex> lock(batches_mutex);
+                    batch_ready.wait(lock, [&] { return !pending_batches.empty(); });
+                    batch = move(pending_batches.front());
+                    pending_batches.pop_front();
+                }
+
+                AnswerBatch(batch, *solver);
+
+                {
+                    lock_guard<mutex> lock(batches_mutex);
+                    answered_batches.push_back(move(batch));
+                }
+                // A full pipe already holds a wake up
+                char wake = 0;
+                while (write(wake_pipe[1], &wake, 1) < 0 && errno == EINTR) {
+                }
+            }
+        });
+    }
+
+    cout << "Serving on " << socket_path << " with " << num_threads << " threads" << endl;
+
+    unordered_map<int, Connection> connections;
+    vector<pollfd> poll_fds;
+    for (;;) {
+        poll_fds.clear();
+        poll_fds.push_back({listener, POLLIN, 0});
+        poll_fds.push_back({wake_pipe[0], POLLIN, 0});
+        for (const auto& entry : connections) {
+            const auto& connection = entry.second;
+            short events = 0;
+            if (!connection.closed && connection.input.size() < MAX_REQUEST_SIZE &&
+                connection.output.size() < MAX_OUTPUT_SIZE) {
+                events |= POLLIN;
+            }
+            if (!connection.output.empty()) {
+                events |= POLLOUT;
+            }
+            // A connection with nothing to read or write is left out, so a hang up does not wake the loop
+            if (events != 0) {
+                poll_fds.push_back({connection.socket, events, 0});
+            }
+        }
+
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cout << "Can not poll the connections: " << strerror(errno) << endl;
+            break;
+        }
+
+        for (size_t i = 2; i < poll_fds.size(); i++) {
+            auto revents = poll_fds[i].revents;
+            auto& connection = connections[poll_fds[i].fd];
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                ReadRequests(connection);
+            }
+            if ((revents & POLLOUT) && !connection.output.empty()) {
+                WriteAnswers(connection);
+            }
+        }
+
+        if (poll_fds[1].revents & POLLIN) {
+            char wake[64];
+            while (read(wake_pipe[0], wake, sizeof(wake)) > 0) {
+            }
+
+            lock_guard<mutex> lock(batches_mutex);
+            for (auto& batch : answered_batches) {
+                auto& connection = connections[batch.socket];
+                connection.busy = false;
+                if (!connection.failed) {
+                    connection.output += batch.responses;
+                }
+            }
+            answered_batches.clear();
+        }
+
+        if (poll_fds[0].revents & POLLIN) {
+            for (;;) {
+                auto socket = accept(listener, nullptr, nullptr);
+                if (socket < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED) {
+                        cout << "Can not accept a connection: " << strerror(errno) << endl;
+                    }
+                    break;
+                }
+                if (!SetNonBlocking(socket)) {
+                    close(socket);
+                    continue;
+                }
+                connections[socket].socket = socket;
+            }
+        }
+
+        // Hand the complete lines of the idle connections to the workers, and close the finished ones
+        auto batches_added = false;
+        for (auto entry = connections.begin(); entry != connections.end();) {
+            auto& connection = entry->second;
+            if (!connection.busy) {
+                Batch batch;
+                if (TakeBatch(connection, batch)) {
+                    connection.busy = true;
+                    lock_guard<mutex> lock(batches_mutex);
+                    pending_batches.push_back(move(batch));
+                    batches_added = true;
+                } else if (connection.closed && connection.output.empty()) {
+                    close(connection.socket);
+                    entry = connections.erase(entry);
+                    continue;
+                }
+            }
+            ++entry;
+        }
+        if (batches_added) {
+            batch_ready.notify_all();
+        }
+    }
+
+    close(listener);
+    unlink(socket_path.c_str());
+    // The workers block on the batch queue, so the process ends without joining them
+    exit(EXIT_FAILURE);
+}
+
+// Take the complete lines of the input as a batch, false if there are none. A line that fills the
+// input can not be a puzzle; it is answered as INVALID, and the rest of it is discarded as it comes
+bool TakeBatch(Connection& connection, Batch& batch) {
+    auto& input = connection.input;
+    if (connection.discarding) {
+        auto end = input.find('\n');
+        if (end == string::npos) {
+            input.clear();
+            return false;
+        }
+        input.erase(0, end + 1);
+        connection.discarding = false;
+    }
+
+    auto last = input.rfind('\n');
+    if (last == string::npos) {
+        if (input.size() >= MAX_REQUEST_SIZE) {
+            connection.output += "INVALID\n";
+            connection.discarding = true;
+            input.clear();
+        }
+        return false;
+    }
+
+    batch.socket = connection.socket;
+    batch.requests.assign(input, 0, last + 1);
+    input.erase(0, last + 1);
+    return true;
+}
+
+// Read the requests the client sent so far, up to a full input; the end of the stream closes the
+// connection. A failed connection has no one to answer, so its requests and answers are dropped
+void ReadRequests(Connection& connection) {
+    if (connection.closed || connection.input.size() >= MAX_REQUEST_SIZE) {
+        return;
+    }
+
+    char buffer[16*1024];
+    auto count = read(connection.socket, buffer, min(sizeof(buffer), MAX_REQUEST_SIZE - connection.input.size()));
+    if (count > 0) {
+        connection.input.append(buffer, count);
+    } else if (count == 0) {
+        connection.closed = true;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        connection.closed = true;
+        connection.failed = true;
+        connection.input.clear();
+        connection.output.clear();
+    }
+}
+
+// Write as much of the answers as the socket takes without blocking
+void WriteAnswers(Connection& connection) {
+    auto count = write(connection.socket, connection.output.data(), connection.output.size());
+    if (count > 0) {
+        connection.output.erase(0, count);
+    } else if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        connection.closed = true;
+        connection.failed = true;
+        connection.input.clear();
+        connection.output.clear();
+    }
+}
+
+// Answer the request lines of the batch in order
+void AnswerBatch(Batch& batch, PuzzleSolver& solver) {
+    const char* line = batch.requests.data();
+    const char* end = line + batch.requests.size();
+    while (line < end) {
+        auto line_end = static_cast<const char*>(memchr(line, '\n', end - line));
+        AnswerRequest(line, line_end - line, solver, batch.responses);
+        line = line_end + 1;
+    }
+}
+
+// Answer one request line: SOLVED or UNSOLVED with the 81 numbers as far as they are solved,
+// INVALID if the line is not a puzzle, and nothing for an empty line
+void AnswerRequest(const char* line, size_t length, PuzzleSolver& solver, string& response) {
+    if (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+    if (length == 0) {
+        return;
+    }
+
+    if (length != Grid::NUM_GRID_CELLS) {
+        response += "INVALID\n";
+        return;
+    }
+    for (size_t i = 0; i < length; i++) {
+        auto num = GetCharNumber(line[i]);
+        if (num > Grid::NUM_BASE || (num == 0 && line[i] != '0' && line[i] != '.' && line[i] != 'x' && line[i] != 'X')) {
+            response += "INVALID\n";
+            return;
+        }
+    }
+
+    // The puzzle is read in place from the request
+    SolveResult result;
+    auto solved = solver.Solve(PuzzleView(line, Grid::GRID_WIDTH), result);
+    response += solved ? "SOLVED " : "UNSOLVED ";
+    for (auto num : result.solution) {
+        response += GetNumberChar(num);
+    }
+    response += '\n';
+}
+
+// Make the reads and writes of the socket or pipe return at once instead of waiting
+bool SetNonBlocking(int socket) {
+    auto flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif